@@ -7,10 +7,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <string>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Solution using a bitmask to mark the seen characters.
  * @return true if the input string has duplicate characters, false otherwise.
@@ -79,6 +84,42 @@ bool has_duplicates_3(const std::string& str)
     return false;
 }
 
+/**
+ * @brief Solution for arbitrary bytes using a 256-bit mask of seen characters.
+ * @return true if the input string has duplicate characters, false otherwise.
+ * @note Complexity: O(1) in both time and space: by the pigeonhole principle,
+ *       any string with more than 256 characters has a duplicate, so at most
+ *       the first 257 characters of the string are ever examined.
+ * @note The scan stops at the first repeated character. Vectorizing it does
+ *       not pay off: the mask test-and-set is a single instruction pair per
+ *       character, and the scanned prefix never exceeds 257 bytes.
+ */
+bool has_duplicates_4(const std::string& str)
+{
+    if (str.size() > 256)
+    {
+        /* there are only 256 distinct characters, so one must repeat */
+        return true;
+    }
+
+    uint64_t chars_seen[4]{};
+
+    for (const char c : str)
+    {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        const uint64_t bit = uint64_t{1} << (byte & 63);
+
+        /* if the character c has already been seen */
+        if (chars_seen[byte >> 6] & bit)
+        {
+            return true;
+        }
+        chars_seen[byte >> 6] |= bit;
+    }
+
+    return false;
+}
+
 /**
  * @brief Generates a random string of length n and characters in [a-z].
  * @note Complexity: O(n) in both time and space.
@@ -100,6 +141,93 @@ std::string random_string(const size_t n)
     return str;
 }
 
+/**
+ * @brief Generates a string of length n <= 256 whose characters are distinct
+ *        (but otherwise arbitrary) bytes.
+ * @note Complexity: O(1) in both time and space.
+ */
+std::string random_unique_string(const size_t n)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    assert(n <= 256);
+
+    std::string str;
+
+    for (int c = 0; c < 256; ++c)
+    {
+        str.push_back(static_cast<char>(c));
+    }
+    std::shuffle(str.begin(), str.end(), generator);
+    str.resize(n);
+
+    return str;
+}
+
+#ifdef BENCHMARK
+
+/*
+ * The solutions are run on [a-z] strings (the only input has_duplicates_1
+ * accepts), on which they find a repeat within a few characters (except for
+ * has_duplicates_2, which sorts the whole string first), and has_duplicates_4
+ * is also run on its worst case: strings starting with 256 distinct bytes.
+ */
+
+template<typename Function>
+void bench_has_duplicates(benchmark::state& state,
+                          Function has_duplicates,
+                          const size_t num_unique = 0)
+{
+    std::string str = random_unique_string(num_unique);
+    str += random_string(state.size() - str.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(has_duplicates(str));
+    }
+
+    state.set_bytes_processed(str.size());
+}
+
+void bench_has_duplicates_1(benchmark::state& state)
+{
+    bench_has_duplicates(state, has_duplicates_1);
+}
+
+void bench_has_duplicates_2(benchmark::state& state)
+{
+    bench_has_duplicates(state, has_duplicates_2);
+}
+
+void bench_has_duplicates_3(benchmark::state& state)
+{
+    bench_has_duplicates(state, has_duplicates_3);
+}
+
+void bench_has_duplicates_4(benchmark::state& state)
+{
+    bench_has_duplicates(state, has_duplicates_4);
+}
+
+void bench_has_duplicates_4_worst(benchmark::state& state)
+{
+    bench_has_duplicates(
+        state, has_duplicates_4, std::min<size_t>(state.size(), 256));
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, size_t{64} << 20, 4);
+
+REGISTER_BENCHMARK(bench_has_duplicates_1, sizes);
+REGISTER_BENCHMARK(bench_has_duplicates_2, sizes);
+REGISTER_BENCHMARK(bench_has_duplicates_3, sizes);
+REGISTER_BENCHMARK(bench_has_duplicates_4, sizes);
+REGISTER_BENCHMARK(bench_has_duplicates_4_worst, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -112,11 +240,40 @@ int main()
 
             assert(has_duplicates_1(str) == result);
             assert(has_duplicates_2(str) == result);
+            assert(has_duplicates_4(str) == result);
         }
 
         std::cout << "passed random tests for strings of length " << n
                   << std::endl;
     }
 
+    for (size_t n = 0; n <= 300; ++n)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            std::string str = random_unique_string(std::min<size_t>(n, 256));
+
+            /* pad past the pigeonhole limit with repeated bytes */
+            while (str.size() < n)
+            {
+                str.push_back(str[(i * 31 + str.size()) % str.size()]);
+            }
+
+            assert(has_duplicates_4(str) == has_duplicates_3(str));
+
+            /* introduce a duplicate (if possible) */
+            if (n >= 2)
+            {
+                str[i % n] = str[(i + 1) % n];
+                assert(has_duplicates_4(str) == true);
+            }
+        }
+
+        std::cout << "passed byte-alphabet tests for strings of length " << n
+                  << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -6,9 +6,26 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <random>
+#include <string>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/* AVX2 kernels are compiled separately and selected at runtime */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HAS_AVX2_DISPATCH
+#endif
 
 /**
  * @brief Reverses an input C-string in place.
@@ -37,6 +54,184 @@ char* reverse_c_string(char* str)
     return str;
 }
 
+#ifdef __SSE2__
+/** @brief Reverses the order of the 16 bytes of a 128-bit register. */
+inline __m128i reverse_bytes(__m128i x)
+{
+    /* reverse the 32-bit words, then the 16-bit words in each of them */
+    x = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+
+    /* swap the two bytes of each 16-bit word */
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+#endif
+
+/**
+ * @brief Reverses the bytes in [first,last) by swapping 16-byte blocks from
+ *        both ends (with SSE2) and the remaining middle bytes one at a time.
+ */
+void reverse_bytes_sse2(char* first, char* last)
+{
+#ifdef __SSE2__
+    while (last - first >= 32)
+    {
+        last -= 16;
+
+        __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i*>(first));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<__m128i*>(last));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(first), reverse_bytes(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(last), reverse_bytes(a));
+
+        first += 16;
+    }
+#endif
+
+    std::reverse(first, last);
+}
+
+#ifdef HAS_AVX2_DISPATCH
+/**
+ * @brief Reverses the bytes in [first,last) by swapping 32-byte blocks from
+ *        both ends (with AVX2; this function is only called on CPUs which
+ *        support it).
+ */
+__attribute__((target("avx2"))) void reverse_bytes_avx2(char* first,
+                                                         char* last)
+{
+    /* reverses the bytes within each 128-bit lane */
+    const __m256i mask = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0,
+                                          15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0);
+
+    while (last - first >= 64)
+    {
+        last -= 32;
+
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<__m256i*>(first));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<__m256i*>(last));
+
+        /* reverse the bytes in each lane, then swap the two lanes */
+        a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, mask), 0x4e);
+        b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, mask), 0x4e);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(first), b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(last), a);
+
+        first += 32;
+    }
+
+    reverse_bytes_sse2(first, last);
+}
+#endif
+
+/**
+ * @brief Reverses the bytes in [first,last) using the widest vector
+ *        instructions supported by the CPU (checked once, at the first call).
+ */
+void reverse_bytes(char* first, char* last)
+{
+#ifdef HAS_AVX2_DISPATCH
+    static void (*const reverse)(char*, char*) =
+        __builtin_cpu_supports("avx2") ? reverse_bytes_avx2
+                                       : reverse_bytes_sse2;
+#else
+    static void (*const reverse)(char*, char*) = reverse_bytes_sse2;
+#endif
+
+    reverse(first, last);
+}
+
+/**
+ * @brief Reverses an input C-string in place using SIMD block swaps.
+ * @return A pointer to the input string (reversed).
+ * @note Complexity: O(n) in time, O(1) in space, where n is the string length.
+ */
+char* reverse_c_string_simd(char* str)
+{
+    reverse_bytes(str, str + std::strlen(str));
+    return str;
+}
+
+/**
+ * @brief Reverses an input UTF-8 C-string in place, keeping the bytes of each
+ *        code point in their original order.
+ * @return A pointer to the input string (reversed).
+ * @note Complexity: O(n) in time, O(1) in space, where n is the string length.
+ * @note After all bytes are reversed, the continuation bytes (10xxxxxx) of a
+ *       code point precede its leading byte, so each such sequence is
+ *       reversed back.
+ */
+char* reverse_utf8_string(char* str)
+{
+    char* last = str + std::strlen(str);
+
+    reverse_bytes(str, last);
+
+    for (char* first = str; first < last;)
+    {
+        /* skip 8 ASCII characters at a time (no byte has its high bit set) */
+        if (last - first >= 8)
+        {
+            uint64_t block;
+            std::memcpy(&block, first, 8);
+
+            if ((block & 0x8080808080808080) == 0)
+            {
+                first += 8;
+                continue;
+            }
+        }
+
+        char* lead = first;
+
+        while (lead < last && (*lead & 0xc0) == 0x80)
+        {
+            ++lead;
+        }
+
+        /* first..lead are continuation bytes, lead is the leading byte */
+        if (lead < last)
+        {
+            ++lead;
+        }
+        std::reverse(first, lead);
+
+        first = lead;
+    }
+
+    return str;
+}
+
+/**
+ * @brief Reverses each of the C-strings stored consecutively in an arena.
+ * @param arena A buffer containing C-strings one after the other (each one
+ *        terminated by '\0').
+ * @param size The arena size (the last byte must be '\0').
+ * @return The number of reversed strings.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the arena size.
+ */
+size_t reverse_c_strings(char* arena, const size_t size)
+{
+    assert(size == 0 || arena[size - 1] == '\0');
+
+    size_t count = 0;
+
+    for (char* str = arena; str < arena + size; ++count)
+    {
+        char* end =
+            static_cast<char*>(std::memchr(str, '\0', arena + size - str));
+
+        reverse_bytes(str, end);
+        str = end + 1;
+    }
+
+    return count;
+}
+
 /**
  * @brief Generates a random C-string of length n and characters in [a-z].
  * @note Complexity: O(n) in both time and space.
@@ -60,6 +255,118 @@ char* random_string(size_t n)
     return str;
 }
 
+/**
+ * @brief Encodes a code point in UTF-8.
+ */
+std::string to_utf8(const uint32_t code_point)
+{
+    std::string str;
+
+    if (code_point < 0x80)
+    {
+        str.push_back(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        str.push_back(0xc0 | (code_point >> 6));
+        str.push_back(0x80 | (code_point & 0x3f));
+    }
+    else if (code_point < 0x10000)
+    {
+        str.push_back(0xe0 | (code_point >> 12));
+        str.push_back(0x80 | ((code_point >> 6) & 0x3f));
+        str.push_back(0x80 | (code_point & 0x3f));
+    }
+    else
+    {
+        str.push_back(0xf0 | (code_point >> 18));
+        str.push_back(0x80 | ((code_point >> 12) & 0x3f));
+        str.push_back(0x80 | ((code_point >> 6) & 0x3f));
+        str.push_back(0x80 | (code_point & 0x3f));
+    }
+
+    return str;
+}
+
+#ifdef BENCHMARK
+
+/*
+ * The strings are made of [a-z] characters, so reverse_utf8_string only pays
+ * for scanning them; the batch function reverses an arena with as many
+ * strings of the given length as fit in 64 MB.
+ */
+
+template<typename Function>
+void bench_reverse(benchmark::state& state, Function reverse)
+{
+    char* str = random_string(state.size());
+
+    while (state.keep_running())
+    {
+        reverse(str);
+        benchmark::clobber_memory();
+    }
+
+    state.set_bytes_processed(state.size());
+
+    delete[] str;
+}
+
+void bench_reverse_c_string(benchmark::state& state)
+{
+    bench_reverse(state, reverse_c_string);
+}
+
+void bench_std_reverse(benchmark::state& state)
+{
+    const size_t n = state.size();
+    bench_reverse(state, [n](char* str) { std::reverse(str, str + n); });
+}
+
+void bench_reverse_c_string_simd(benchmark::state& state)
+{
+    bench_reverse(state, reverse_c_string_simd);
+}
+
+void bench_reverse_utf8_string(benchmark::state& state)
+{
+    bench_reverse(state, reverse_utf8_string);
+}
+
+void bench_reverse_c_strings(benchmark::state& state)
+{
+    const size_t n = state.size();
+    const size_t arena_size = size_t{64} << 20;
+
+    std::vector<char> arena(std::max<size_t>(arena_size / (n + 1), 1) * (n + 1),
+                            'a');
+    for (size_t i = n; i < arena.size(); i += n + 1)
+    {
+        arena[i] = '\0';
+    }
+
+    while (state.keep_running())
+    {
+        reverse_c_strings(arena.data(), arena.size());
+        benchmark::clobber_memory();
+    }
+
+    state.set_items_processed(arena.size() / (n + 1));
+    state.set_bytes_processed(arena.size());
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, size_t{64} << 20, 4);
+
+REGISTER_BENCHMARK(bench_reverse_c_string, sizes);
+REGISTER_BENCHMARK(bench_std_reverse, sizes);
+REGISTER_BENCHMARK(bench_reverse_c_string_simd, sizes);
+REGISTER_BENCHMARK(bench_reverse_utf8_string, sizes);
+REGISTER_BENCHMARK(bench_reverse_c_strings, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -74,6 +381,12 @@ int main()
 
             assert(strcmp(str, str_copy.c_str()) == 0);
 
+            /* reverse it back */
+            reverse_c_string_simd(str);
+            std::reverse(str_copy.begin(), str_copy.end());
+
+            assert(strcmp(str, str_copy.c_str()) == 0);
+
             delete[] str;
         }
 
@@ -81,5 +394,52 @@ int main()
                   << std::endl;
     }
 
+    std::random_device device;
+    std::mt19937 generator(device());
+
+    /* code points with 1, 2, 3 and 4 bytes in UTF-8 */
+    std::uniform_int_distribution<uint32_t> code_points[] = {
+        std::uniform_int_distribution<uint32_t>(1, 0x7f),
+        std::uniform_int_distribution<uint32_t>(0x80, 0x7ff),
+        std::uniform_int_distribution<uint32_t>(0x800, 0xffff),
+        std::uniform_int_distribution<uint32_t>(0x10000, 0x10ffff)};
+    std::uniform_int_distribution<int> num_bytes(0, 3);
+
+    for (size_t n = 0; n <= 100; ++n)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            std::vector<std::string> chars;
+            for (size_t k = 0; k < n; ++k)
+            {
+                chars.push_back(
+                    to_utf8(code_points[num_bytes(generator)](generator)));
+            }
+
+            std::string str;
+            std::string str_reversed;
+            for (size_t k = 0; k < n; ++k)
+            {
+                str += chars[k];
+                str_reversed += chars[n - 1 - k];
+            }
+
+            reverse_utf8_string(&str[0]);
+            assert(str == str_reversed);
+
+            /* an arena with the string, an empty string and the string */
+            std::string arena = str + '\0' + '\0' + str + '\0';
+            std::reverse(str.begin(), str.end());
+
+            assert(reverse_c_strings(&arena[0], arena.size()) == 3);
+            assert(arena == str + '\0' + '\0' + str + '\0');
+        }
+
+        std::cout << "passed UTF-8 tests for strings of " << n
+                  << " code points" << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -4,11 +4,19 @@
  *       a copy of it). As an example: "abcadbce" is changed into "abcde".
  */
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <random>
+#include <sstream>
 #include <string>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Solution without using an additional buffer.
@@ -96,6 +104,98 @@ std::string& remove_duplicates_2(std::string& str)
     return str;
 }
 
+/**
+ * @brief Copies the characters of [str, str+n) which are not marked in a
+ *        256-bit mask of seen characters to out, marking them as seen.
+ * @param out The output buffer: it may start at str (for in-place use).
+ * @param seen The mask of seen characters (updated by this function).
+ * @return The number of characters copied to out.
+ * @note Complexity: O(n) in time, O(1) in space.
+ * @note Since at most 256 characters can be kept, the scan stops once all
+ *       of them have been seen.
+ */
+size_t remove_seen_chars(const char* str,
+                         const size_t n,
+                         char* out,
+                         uint64_t (&seen)[4])
+{
+    /* a local copy of the mask, which cannot be aliased by out */
+    uint64_t mask[4] = {seen[0], seen[1], seen[2], seen[3]};
+
+    size_t i = 0;
+
+    for (size_t j = 0; j < n; ++j)
+    {
+        const unsigned char c = str[j];
+        const uint64_t bit = uint64_t{1} << (c & 63);
+
+        /* if the character c has already been seen */
+        if (mask[c >> 6] & bit)
+        {
+            continue;
+        }
+
+        mask[c >> 6] |= bit;
+        out[i] = c;
+        ++i;
+
+        /* every possible character has been seen */
+        if ((mask[0] & mask[1] & mask[2] & mask[3]) == ~uint64_t{0})
+        {
+            break;
+        }
+    }
+
+    std::copy(mask, mask + 4, seen);
+
+    return i;
+}
+
+/**
+ * @brief Solution using a 256-bit mask to track seen characters (the input
+ *        string is allowed to contain arbitrary bytes).
+ * @return A reference to the input string with all duplicate characters
+ *         removed.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the string length.
+ */
+std::string& remove_duplicates_3(std::string& str)
+{
+    uint64_t seen[4] = {};
+
+    str.resize(remove_seen_chars(str.data(), str.size(), &str[0], seen));
+    str.shrink_to_fit();
+
+    return str;
+}
+
+/**
+ * @brief Reads a stream in chunks and returns its characters with all
+ *        duplicates removed (the stream is allowed to contain arbitrary
+ *        bytes).
+ * @param chunk_size The number of characters read at a time.
+ * @note Complexity: O(n) in time, O(k) in space, where n is the stream
+ *       length and k is the chunk size (reading stops as soon as all 256
+ *       possible characters have been seen).
+ */
+std::string remove_duplicates(std::istream& in,
+                              const size_t chunk_size = 1 << 16)
+{
+    uint64_t seen[4] = {};
+
+    std::vector<char> buffer(chunk_size);
+    std::string result;
+
+    while (result.size() < 256 &&
+           (in.read(buffer.data(), chunk_size) || in.gcount() > 0))
+    {
+        size_t n = remove_seen_chars(
+            buffer.data(), in.gcount(), buffer.data(), seen);
+        result.append(buffer.data(), n);
+    }
+
+    return result;
+}
+
 /**
  * @brief Generates a random ASCII string of length n.
  * @note Complexity: O(n) in both time and space.
@@ -117,6 +217,69 @@ std::string random_string(const size_t n)
     return str;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The strings are ASCII strings in which the character 127 never occurs, so
+ * no solution can stop early.
+ */
+
+template<typename Function>
+void bench_remove_duplicates(benchmark::state& state,
+                             Function remove_duplicates)
+{
+    std::string str = random_string(state.size());
+    std::replace(str.begin(), str.end(), '\x7f', 'a');
+
+    std::string str_copy;
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        str_copy = str;
+        state.resume_timing();
+
+        remove_duplicates(str_copy);
+        benchmark::do_not_optimize(str_copy);
+    }
+
+    state.set_bytes_processed(str.size());
+}
+
+void bench_remove_duplicates_1(benchmark::state& state)
+{
+    bench_remove_duplicates(state, remove_duplicates_1);
+}
+
+void bench_remove_duplicates_2(benchmark::state& state)
+{
+    bench_remove_duplicates(state, remove_duplicates_2);
+}
+
+void bench_remove_duplicates_3(benchmark::state& state)
+{
+    bench_remove_duplicates(state, remove_duplicates_3);
+}
+
+void bench_remove_duplicates_stream(benchmark::state& state)
+{
+    bench_remove_duplicates(state, [](std::string& str) {
+        std::istringstream in(str);
+        str = remove_duplicates(in);
+    });
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, size_t{64} << 20, 4);
+
+REGISTER_BENCHMARK(bench_remove_duplicates_1, sizes);
+REGISTER_BENCHMARK(bench_remove_duplicates_2, sizes);
+REGISTER_BENCHMARK(bench_remove_duplicates_3, sizes);
+REGISTER_BENCHMARK(bench_remove_duplicates_stream, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -125,16 +288,49 @@ int main()
         {
             std::string str = random_string(n);
             std::string str_copy(str);
+            std::string str_copy_3(str);
+            std::istringstream in(str);
 
             remove_duplicates_1(str);
             remove_duplicates_2(str_copy);
+            remove_duplicates_3(str_copy_3);
 
             assert(str == str_copy);
+            assert(str == str_copy_3);
+            assert(remove_duplicates(in, 1 + i % 8) == str);
         }
 
         std::cout << "passed random tests for strings of length " << n
                   << std::endl;
     }
 
+    /* strings with arbitrary bytes (mostly longer than 256 characters) */
+    std::random_device device;
+    std::mt19937 generator(device());
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    for (size_t n = 0; n <= 2000; n += 10)
+    {
+        std::string str;
+        while (str.size() < n)
+        {
+            str.push_back(static_cast<char>(distribution(generator)));
+        }
+
+        std::string str_copy = str;
+        std::istringstream in(str);
+
+        remove_duplicates_1(str);
+        remove_duplicates_3(str_copy);
+
+        assert(str == str_copy);
+        assert(remove_duplicates(in, 64) == str);
+    }
+
+    std::cout << "passed random tests for strings with arbitrary bytes"
+              << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
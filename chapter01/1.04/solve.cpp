@@ -6,10 +6,18 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <string>
+#include <utility>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Solution using sorting.
@@ -71,6 +79,154 @@ bool is_anagram_2(const std::string& str1, const std::string& str2)
     return true;
 }
 
+/**
+ * @brief A signature of a string which is the same for two strings if and
+ *        only if they are anagrams: the number of occurrences of each of the
+ *        256 possible characters, plus a 64-bit hash of this multiset of
+ *        characters which allows most non-anagrams to be told apart by
+ *        comparing a single integer.
+ */
+class anagram_signature
+{
+public:
+    /**
+     * @brief Builds the signature of a string.
+     * @note Complexity: O(n) in time, O(1) in space, where n is the string
+     *       length.
+     */
+    explicit anagram_signature(const std::string& str) : counts_()
+    {
+        const unsigned char* chars =
+            reinterpret_cast<const unsigned char*>(str.data());
+        size_t n = str.size();
+        size_t i = 0;
+
+        if (n >= 1024)
+        {
+            /*
+             * count into four histograms so that runs of equal characters
+             * do not serialize on a single counter
+             */
+            uint32_t counts[4][256]{};
+
+            for (; i + 4 <= n; i += 4)
+            {
+                ++counts[0][chars[i]];
+                ++counts[1][chars[i + 1]];
+                ++counts[2][chars[i + 2]];
+                ++counts[3][chars[i + 3]];
+            }
+
+            for (size_t c = 0; c < 256; ++c)
+            {
+                counts_[c] = counts[0][c] + counts[1][c] + counts[2][c] +
+                             counts[3][c];
+            }
+        }
+
+        for (; i < n; ++i)
+        {
+            ++counts_[chars[i]];
+        }
+
+        /* each character c contributes mix(c) to the multiset hash */
+        static const std::array<uint64_t, 256> mixed = mix_all();
+
+        for (size_t c = 0; c < 256; ++c)
+        {
+            hash_ += counts_[c] * mixed[c];
+        }
+    }
+
+    /**
+     * @brief Determines if the strings of two signatures are anagrams.
+     * @note Complexity: O(1) in both time and space.
+     */
+    bool operator==(const anagram_signature& other) const
+    {
+        return hash_ == other.hash_ && counts_ == other.counts_;
+    }
+
+private:
+    /** @brief A 64-bit mixing function (the finalizer of splitmix64). */
+    static uint64_t mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    /** @brief Returns the values of mix(c) for all characters c. */
+    static std::array<uint64_t, 256> mix_all()
+    {
+        std::array<uint64_t, 256> mixed;
+
+        for (size_t c = 0; c < 256; ++c)
+        {
+            mixed[c] = mix(c);
+        }
+
+        return mixed;
+    }
+
+    /* the hash comes first: it is usually the only member read */
+    uint64_t hash_ = 0;
+    std::array<uint32_t, 256> counts_;
+};
+
+/**
+ * @brief Solution using character-count signatures (the input strings are
+ *        allowed to contain arbitrary bytes).
+ * @return true if str1 and str2 are anagrams, false otherwise.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the length of the
+ *       longest string.
+ */
+bool is_anagram_3(const std::string& str1, const std::string& str2)
+{
+    if (str1.size() != str2.size())
+    {
+        return false;
+    }
+
+    return anagram_signature(str1) == anagram_signature(str2);
+}
+
+/**
+ * @brief Determines which pairs of strings are anagrams, computing the
+ *        signature of each string only once.
+ * @param strings The strings to compare.
+ * @param pairs The pairs of indices of the strings to compare.
+ * @return A vector whose i-th element is true if the strings in the i-th
+ *         pair are anagrams, false otherwise.
+ * @note Complexity: O(n + p) in time, O(s + p) in space, where n is the total
+ *       length of the strings, s is the number of strings and p is the
+ *       number of pairs.
+ */
+std::vector<bool> are_anagrams(
+    const std::vector<std::string>& strings,
+    const std::vector<std::pair<size_t, size_t>>& pairs)
+{
+    std::vector<anagram_signature> signatures;
+    signatures.reserve(strings.size());
+
+    for (const std::string& str : strings)
+    {
+        signatures.emplace_back(str);
+    }
+
+    std::vector<bool> result;
+    result.reserve(pairs.size());
+
+    for (const std::pair<size_t, size_t>& pair : pairs)
+    {
+        assert(pair.first < strings.size() && pair.second < strings.size());
+        result.push_back(signatures[pair.first] == signatures[pair.second]);
+    }
+
+    return result;
+}
+
 /**
  * @brief Generates a random ASCII string of length n.
  * @note Complexity: O(n) in both time and space.
@@ -92,6 +248,100 @@ std::string random_string(const size_t n)
     return str;
 }
 
+#ifdef BENCHMARK
+
+/**
+ * @brief A set of strings of the same length and pairs of indices of strings
+ *        to compare (each string takes part in ten pairs on average, and
+ *        about half of the pairs are anagrams).
+ */
+struct workload
+{
+    explicit workload(const size_t n)
+    {
+        std::random_device device;
+        std::mt19937 generator(device());
+
+        const size_t num_strings = 100000;
+
+        for (size_t i = 0; i < num_strings; ++i)
+        {
+            strings.push_back(random_string(n));
+        }
+        for (size_t i = 1; i < num_strings; i += 2)
+        {
+            strings[i] = strings[i - 1];
+            std::shuffle(strings[i].begin(), strings[i].end(), generator);
+        }
+
+        std::uniform_int_distribution<size_t> distribution(0, num_strings - 1);
+
+        for (size_t i = 0; i < 10 * num_strings; ++i)
+        {
+            size_t j = distribution(generator);
+            pairs.emplace_back(j, (i % 2 == 0) ? (j ^ 1) : i % num_strings);
+        }
+    }
+
+    std::vector<std::string> strings;
+    std::vector<std::pair<size_t, size_t>> pairs;
+};
+
+template<typename Function>
+void bench_is_anagram(benchmark::state& state, Function is_anagram)
+{
+    workload input(state.size());
+
+    while (state.keep_running())
+    {
+        for (const std::pair<size_t, size_t>& pair : input.pairs)
+        {
+            benchmark::do_not_optimize(is_anagram(input.strings[pair.first],
+                                                  input.strings[pair.second]));
+        }
+    }
+
+    state.set_items_processed(input.pairs.size());
+}
+
+void bench_is_anagram_1(benchmark::state& state)
+{
+    bench_is_anagram(state, is_anagram_1);
+}
+
+void bench_is_anagram_2(benchmark::state& state)
+{
+    bench_is_anagram(state, is_anagram_2);
+}
+
+void bench_is_anagram_3(benchmark::state& state)
+{
+    bench_is_anagram(state, is_anagram_3);
+}
+
+void bench_are_anagrams(benchmark::state& state)
+{
+    workload input(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(are_anagrams(input.strings, input.pairs));
+    }
+
+    state.set_items_processed(input.pairs.size());
+}
+
+const std::vector<size_t> sizes = benchmark::range(4, 1024, 4);
+
+REGISTER_BENCHMARK(bench_is_anagram_1, sizes);
+REGISTER_BENCHMARK(bench_is_anagram_2, sizes);
+REGISTER_BENCHMARK(bench_is_anagram_3, sizes);
+REGISTER_BENCHMARK(bench_are_anagrams, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -104,13 +354,81 @@ int main()
             std::string str1 = random_string(n);
             std::string str2 = random_string(n);
 
-            assert(is_anagram_1(str1, str2) == is_anagram_2(str1, str2));
+            bool result = is_anagram_1(str1, str2);
+
+            assert(is_anagram_2(str1, str2) == result);
+            assert(is_anagram_3(str1, str2) == result);
 
             std::string str1_shuf = str1;
             std::shuffle(str1_shuf.begin(), str1_shuf.end(), generator);
 
             assert(is_anagram_1(str1, str1_shuf) == true);
             assert(is_anagram_2(str1, str1_shuf) == true);
+            assert(is_anagram_3(str1, str1_shuf) == true);
+
+            std::vector<std::string> strings = {str1, str2, str1_shuf};
+            std::vector<bool> batch =
+                are_anagrams(strings, {{0, 1}, {0, 2}, {2, 1}, {1, 1}});
+
+            assert(batch[0] == result);
+            assert(batch[1] == true);
+            assert(batch[2] == result);
+            assert(batch[3] == true);
+
+            /* move all characters outside the ASCII range */
+            for (std::string* str : {&str1, &str2, &str1_shuf})
+            {
+                for (char& c : *str)
+                {
+                    c = static_cast<char>(c ^ 0x80);
+                }
+            }
+
+            assert(is_anagram_3(str1, str2) == result);
+            assert(is_anagram_3(str1, str1_shuf) == true);
+        }
+
+        std::cout << "passed random tests for strings of length " << n
+                  << std::endl;
+    }
+
+    /*
+     * long strings take the four-histogram path of anagram_signature; lengths
+     * which are not multiples of four also exercise its scalar tail
+     */
+    for (size_t n : {1024, 1025, 1026, 1027, 4093, 4094, 4095, 4096})
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            std::string str1 = random_string(n);
+            std::string str2 = random_string(n);
+
+            std::string str1_shuf = str1;
+            std::shuffle(str1_shuf.begin(), str1_shuf.end(), generator);
+
+            /* differs from str1_shuf by a single character in the tail */
+            std::string str1_tail = str1_shuf;
+            str1_tail.back() = static_cast<char>((str1_tail.back() + 1) % 128);
+
+            std::vector<std::string> strings = {str1, str2, str1_shuf,
+                                                str1_tail};
+            std::vector<std::pair<size_t, size_t>> pairs = {
+                {0, 1}, {0, 2}, {0, 3}, {2, 3}, {3, 1}};
+            std::vector<bool> batch = are_anagrams(strings, pairs);
+
+            for (size_t j = 0; j < pairs.size(); ++j)
+            {
+                const std::string& first = strings[pairs[j].first];
+                const std::string& second = strings[pairs[j].second];
+
+                bool result = is_anagram_1(first, second);
+
+                assert(is_anagram_3(first, second) == result);
+                assert(batch[j] == result);
+            }
+
+            assert(batch[1] == true);
+            assert(batch[2] == false);
         }
 
         std::cout << "passed random tests for strings of length " << n
@@ -119,3 +437,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
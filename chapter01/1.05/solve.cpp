@@ -4,10 +4,20 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <random>
+#include <sstream>
 #include <string>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Replaces spaces with "%20" on a string without using an extra buffer.
@@ -62,6 +72,261 @@ void replace_spaces_2(std::string& str)
     str.swap(result);
 }
 
+/**
+ * @brief A set of characters which must be percent-encoded: entry c is 1 if
+ *        the character c must be replaced with "%XY" (where XY is the
+ *        hexadecimal value of c), 0 otherwise.
+ */
+typedef std::array<unsigned char, 256> encoding_set;
+
+/**
+ * @brief Returns the set containing only the space character (with which
+ *        percent-encoding is the same as replace_spaces_1).
+ * @note The set is built only once, on the first call.
+ */
+const encoding_set& space_encoding_set()
+{
+    static const encoding_set encoded = [] {
+        encoding_set result{};
+        result[' '] = 1;
+        return result;
+    }();
+
+    return encoded;
+}
+
+/**
+ * @brief Returns the set of all characters except the "unreserved" ones of
+ *        RFC 3986, i.e., [A-Za-z0-9] and '-', '.', '_', '~'.
+ * @note The set is built only once, on the first call, from explicit ASCII
+ *       ranges (std::isalnum would make it depend on the current locale).
+ */
+const encoding_set& url_encoding_set()
+{
+    static const encoding_set encoded = [] {
+        encoding_set result;
+        result.fill(1);
+
+        for (int c = 0; c < 256; ++c)
+        {
+            if (('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') ||
+                ('0' <= c && c <= '9') || c == '-' || c == '.' || c == '_' ||
+                c == '~')
+            {
+                result[c] = 0;
+            }
+        }
+
+        return result;
+    }();
+
+    return encoded;
+}
+
+/**
+ * @brief Computes the length of a string after percent-encoding.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the string length.
+ * @note The loop is branch-free (each character adds 0 or 2 to the result),
+ *       so the compiler can unroll it and the cost does not depend on how the
+ *       encoded characters are distributed.
+ */
+size_t encoded_size(const char* str,
+                    const size_t n,
+                    const encoding_set& encoded)
+{
+    size_t extra = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        extra += encoded[static_cast<unsigned char>(str[i])];
+    }
+
+    /* each encoded character adds two characters */
+    return n + 2 * extra;
+}
+
+/**
+ * @brief Percent-encodes the string [str, str+n) into a buffer.
+ * @param out The output buffer: it must have room for encoded_size(str, n)
+ *        characters and either start at str (to encode in place) or not
+ *        overlap with [str, str+n).
+ * @return The length of the encoded string.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the string length.
+ * @note The buffer is filled backwards, so when out == str each character is
+ *       read before its position is overwritten. Runs of characters which are
+ *       not encoded are moved with a single memmove.
+ */
+size_t percent_encode(const char* str,
+                      const size_t n,
+                      char* out,
+                      const encoding_set& encoded = url_encoding_set())
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    size_t size = encoded_size(str, n, encoded);
+
+    for (size_t i = size, j = n; j > 0;)
+    {
+        /* find the run str[k..j) of characters which are kept as they are */
+        size_t k = j;
+        while (k > 0 && !encoded[static_cast<unsigned char>(str[k - 1])])
+        {
+            --k;
+        }
+
+        /* move the whole run at once (it may overlap with its destination) */
+        i -= j - k;
+        std::memmove(out + i, str + k, j - k);
+        j = k;
+
+        /* encode the character preceding the run */
+        if (j > 0)
+        {
+            unsigned char c = str[j - 1];
+
+            out[i - 1] = hex[c % 16];
+            out[i - 2] = hex[c / 16];
+            out[i - 3] = '%';
+            i -= 3;
+            --j;
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief Percent-encodes a string in place.
+ * @note Complexity: O(n) in time, O(1) in space (besides growing the string
+ *       once, which may reallocate it), where n is the string length.
+ */
+void percent_encode(std::string& str,
+                    const encoding_set& encoded = url_encoding_set())
+{
+    size_t n = str.size();
+
+    str.resize(encoded_size(str.data(), n, encoded));
+    percent_encode(&str[0], n, &str[0], encoded);
+}
+
+/**
+ * @brief Returns the value of a hexadecimal digit, or -1 if c is not one.
+ */
+int hex_value(const char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Decodes the percent-encoded string [str, str+n) into a buffer.
+ * @param out The output buffer: it must have room for n characters and
+ *        either start at str (to decode in place) or not overlap with
+ *        [str, str+n).
+ * @return The length of the decoded string.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the string length.
+ * @note A '%' which is not followed by two hexadecimal digits is copied
+ *       unchanged.
+ */
+size_t percent_decode(const char* str, const size_t n, char* out)
+{
+    size_t i = 0;
+
+    for (size_t j = 0; j < n; ++j)
+    {
+        int high = (str[j] == '%' && j + 2 < n) ? hex_value(str[j + 1]) : -1;
+        int low = (high >= 0) ? hex_value(str[j + 2]) : -1;
+
+        if (low >= 0)
+        {
+            out[i] = static_cast<char>(16 * high + low);
+            j += 2;
+        }
+        else
+        {
+            out[i] = str[j];
+        }
+        ++i;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Percent-encodes a stream in chunks (so the whole input is never held
+ *        in memory).
+ * @param chunk_size The number of input characters encoded at a time.
+ * @note Complexity: O(n) in time, O(k) in space, where n is the length of the
+ *       input and k is the chunk size.
+ */
+void percent_encode(std::istream& in,
+                    std::ostream& out,
+                    const encoding_set& encoded = url_encoding_set(),
+                    const size_t chunk_size = 1 << 16)
+{
+    /* a chunk grows at most three times in size when encoded */
+    std::vector<char> buffer(3 * chunk_size);
+
+    while (in.read(buffer.data(), chunk_size) || in.gcount() > 0)
+    {
+        size_t n = in.gcount();
+        out.write(buffer.data(),
+                  percent_encode(buffer.data(), n, buffer.data(), encoded));
+    }
+}
+
+/**
+ * @brief Decodes a percent-encoded stream in chunks (so the whole input is
+ *        never held in memory).
+ * @param chunk_size The number of input characters decoded at a time.
+ * @note Complexity: O(n) in time, O(k) in space, where n is the length of the
+ *       input and k is the chunk size.
+ */
+void percent_decode(std::istream& in,
+                    std::ostream& out,
+                    const size_t chunk_size = 1 << 16)
+{
+    /* an escape sequence may be split between chunks: up to two characters
+     * of the previous chunk are carried over */
+    std::vector<char> buffer(chunk_size + 2);
+    size_t carried = 0;
+
+    while (in.read(buffer.data() + carried, chunk_size) || in.gcount() > 0)
+    {
+        size_t n = carried + in.gcount();
+
+        carried = 0;
+        if (in && n >= 1 && buffer[n - 1] == '%')
+        {
+            carried = 1;
+        }
+        else if (in && n >= 2 && buffer[n - 2] == '%')
+        {
+            carried = 2;
+        }
+
+        out.write(buffer.data(),
+                  percent_decode(buffer.data(), n - carried, buffer.data()));
+
+        std::copy(buffer.begin() + (n - carried),
+                  buffer.begin() + n,
+                  buffer.begin());
+    }
+
+    out.write(buffer.data(), carried);
+}
+
 /**
  * @brief Generates a random string of length n and characters in [a-d ], i.e.,
  *        { 'a', 'b', 'c', 'd', ' ' }.
@@ -86,6 +351,147 @@ std::string random_string(const size_t n)
     return str;
 }
 
+/**
+ * @brief Generates a random string of length n with arbitrary characters.
+ * @note Complexity: O(n) in both time and space.
+ */
+std::string random_bytes(const size_t n)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    std::string str;
+
+    while (str.size() < n)
+    {
+        str.push_back(static_cast<char>(distribution(generator)));
+    }
+
+    return str;
+}
+
+#ifdef BENCHMARK
+
+/**
+ * @brief Generates a random text of length n in which 10% of the characters
+ *        are spaces and the others are in [a-z].
+ */
+std::string random_text(const size_t n)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::bernoulli_distribution is_space(0.1);
+    std::uniform_int_distribution<char> letter('a', 'z');
+
+    std::string str;
+    str.reserve(n);
+
+    while (str.size() < n)
+    {
+        str.push_back(is_space(generator) ? ' ' : letter(generator));
+    }
+
+    return str;
+}
+
+/* the function is run on a copy of the text, with enough room to grow */
+template<typename Function>
+void bench_transform(benchmark::state& state,
+                     Function transform,
+                     const std::string& text)
+{
+    std::string str;
+    str.reserve(3 * text.size());
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        str = text;
+        state.resume_timing();
+
+        transform(str);
+        benchmark::do_not_optimize(str);
+    }
+
+    state.set_bytes_processed(text.size());
+}
+
+void bench_replace_spaces_1(benchmark::state& state)
+{
+    bench_transform(state, replace_spaces_1, random_text(state.size()));
+}
+
+void bench_replace_spaces_2(benchmark::state& state)
+{
+    bench_transform(state, replace_spaces_2, random_text(state.size()));
+}
+
+void bench_percent_encode_in_place(benchmark::state& state)
+{
+    const encoding_set spaces = space_encoding_set();
+
+    bench_transform(
+        state,
+        [&spaces](std::string& str) { percent_encode(str, spaces); },
+        random_text(state.size()));
+}
+
+void bench_percent_encode_to_buffer(benchmark::state& state)
+{
+    const encoding_set spaces = space_encoding_set();
+    std::vector<char> buffer(3 * state.size());
+
+    bench_transform(state,
+                    [&](std::string& str) {
+                        percent_encode(
+                            str.data(), str.size(), buffer.data(), spaces);
+                    },
+                    random_text(state.size()));
+}
+
+void bench_percent_encode_stream(benchmark::state& state)
+{
+    const encoding_set spaces = space_encoding_set();
+
+    bench_transform(state,
+                    [&spaces](std::string& str) {
+                        std::istringstream in(str);
+                        std::ostringstream out;
+                        percent_encode(in, out, spaces);
+                        str = out.str();
+                    },
+                    random_text(state.size()));
+}
+
+void bench_percent_decode(benchmark::state& state)
+{
+    std::string text = random_text(state.size());
+    percent_encode(text, space_encoding_set());
+
+    bench_transform(state,
+                    [](std::string& str) {
+                        str.resize(
+                            percent_decode(str.data(), str.size(), &str[0]));
+                    },
+                    text);
+}
+
+const std::vector<size_t> sizes = benchmark::range(1 << 10, 1 << 30, 16);
+
+REGISTER_BENCHMARK(bench_replace_spaces_1, sizes);
+REGISTER_BENCHMARK(bench_replace_spaces_2, sizes);
+REGISTER_BENCHMARK(bench_percent_encode_in_place, sizes);
+REGISTER_BENCHMARK(bench_percent_encode_to_buffer, sizes);
+REGISTER_BENCHMARK(bench_percent_encode_stream, sizes);
+REGISTER_BENCHMARK(bench_percent_decode, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -95,15 +501,78 @@ int main()
             std::string str1 = random_string(n);
             std::string str2 = str1;
 
+            std::string str3 = str1;
+
             replace_spaces_1(str1);
             replace_spaces_2(str2);
+            percent_encode(str3, space_encoding_set());
 
             assert(str1 == str2);
+            assert(str1 == str3);
         }
 
         std::cout << "passed random tests for strings of length " << n
                   << std::endl;
     }
 
+    for (size_t n = 0; n <= 100; ++n)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            const std::string str = random_bytes(n);
+
+            /* encoding into a separate buffer */
+            std::string encoded(3 * n, '\0');
+            encoded.resize(percent_encode(str.data(), n, &encoded[0]));
+
+            for (char c : encoded)
+            {
+                assert(std::isalnum(c) || std::string("%-._~").find(c) !=
+                                              std::string::npos);
+            }
+
+            /* encoding in place */
+            std::string str_copy = str;
+            percent_encode(str_copy);
+            assert(str_copy == encoded);
+
+            /* decoding in place */
+            str_copy.resize(
+                percent_decode(str_copy.data(), str_copy.size(), &str_copy[0]));
+            assert(str_copy == str);
+
+            /* encoding/decoding streams with escapes split between chunks */
+            for (size_t chunk_size = 1; chunk_size <= 4; ++chunk_size)
+            {
+                std::istringstream in(str);
+                std::ostringstream out;
+                percent_encode(in, out, url_encoding_set(), chunk_size);
+                assert(out.str() == encoded);
+
+                std::istringstream encoded_in(encoded);
+                std::ostringstream decoded_out;
+                percent_decode(encoded_in, decoded_out, chunk_size);
+                assert(decoded_out.str() == str);
+            }
+        }
+
+        std::cout << "passed encoding/decoding tests for strings of length "
+                  << n << std::endl;
+    }
+
+    /* a '%' which does not start an escape sequence is kept */
+    for (std::string str : {"%", "%4", "%%41", "%4g%41", "100%"})
+    {
+        std::istringstream in(str);
+        std::ostringstream out;
+        percent_decode(in, out, 2);
+
+        std::string decoded(str.size(), '\0');
+        decoded.resize(percent_decode(str.data(), str.size(), &decoded[0]));
+        assert(out.str() == decoded);
+    }
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -5,12 +5,23 @@
  *       matrix).
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 class square_matrix
 {
 public:
@@ -36,6 +47,16 @@ public:
         return n_;
     }
 
+    int* data()
+    {
+        return values_.data();
+    }
+
+    const int* data() const
+    {
+        return values_.data();
+    }
+
     bool operator==(const square_matrix& B) const
     {
         return values_ == B.values_;
@@ -117,6 +138,354 @@ square_matrix& rotate_square_matrix_2(square_matrix& A)
     return A;
 }
 
+/** @brief Supported rotations of a square matrix. */
+enum class rotation
+{
+    counterclockwise,
+    clockwise,
+    half_turn
+};
+
+/* blocks with at most this many rows and columns are rotated directly */
+const size_t block_size = 32;
+
+/**
+ * @brief A 4×4 block of matrix elements which is held in registers while it
+ *        is moved (with SSE2, each row of the tile is a 128-bit register).
+ */
+struct tile
+{
+    /**
+     * @brief Loads the tile whose first row starts at p (consecutive rows
+     *        are stride elements apart).
+     */
+    void load(const int* p, const ptrdiff_t stride)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+#ifdef __SSE2__
+            rows_[r] = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(p + r * stride));
+#else
+            std::copy(p + r * stride, p + r * stride + 4, rows_[r]);
+#endif
+        }
+    }
+
+    /**
+     * @brief Stores the tile such that its first row starts at p (consecutive
+     *        rows are stride elements apart).
+     */
+    void store(int* p, const ptrdiff_t stride) const
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+#ifdef __SSE2__
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p + r * stride),
+                             rows_[r]);
+#else
+            std::copy(rows_[r], rows_[r] + 4, p + r * stride);
+#endif
+        }
+    }
+
+    /** @brief Transposes the tile. */
+    void transpose()
+    {
+#ifdef __SSE2__
+        __m128i t0 = _mm_unpacklo_epi32(rows_[0], rows_[1]);
+        __m128i t1 = _mm_unpacklo_epi32(rows_[2], rows_[3]);
+        __m128i t2 = _mm_unpackhi_epi32(rows_[0], rows_[1]);
+        __m128i t3 = _mm_unpackhi_epi32(rows_[2], rows_[3]);
+
+        rows_[0] = _mm_unpacklo_epi64(t0, t1);
+        rows_[1] = _mm_unpackhi_epi64(t0, t1);
+        rows_[2] = _mm_unpacklo_epi64(t2, t3);
+        rows_[3] = _mm_unpackhi_epi64(t2, t3);
+#else
+        for (int r = 0; r < 4; ++r)
+        {
+            for (int c = r + 1; c < 4; ++c)
+            {
+                std::swap(rows_[r][c], rows_[c][r]);
+            }
+        }
+#endif
+    }
+
+    /** @brief Reverses the order of the elements on each row of the tile. */
+    void reverse_rows()
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+#ifdef __SSE2__
+            rows_[r] = _mm_shuffle_epi32(rows_[r], _MM_SHUFFLE(0, 1, 2, 3));
+#else
+            std::reverse(rows_[r], rows_[r] + 4);
+#endif
+        }
+    }
+
+#ifdef __SSE2__
+    __m128i rows_[4];
+#else
+    int rows_[4][4];
+#endif
+};
+
+/**
+ * @brief Splits the range [first,last) in two halves, keeping the splitting
+ *        point at a multiple of 4 relative to first (so that all subranges
+ *        except the last one consist of whole 4×4 tiles).
+ */
+size_t split_point(const size_t first, const size_t last)
+{
+    return first + (((last - first) / 2 + 3) & ~size_t{3});
+}
+
+/**
+ * @brief Copies the block [i0,i1)×[j0,j1) of the n×n matrix a into the n×n
+ *        matrix b, rotated by 90 degrees in the given direction.
+ * @note The block is recursively split until it fits in the cache (the
+ *       recursion is cache-oblivious), and its 4×4 tiles are then moved
+ *       through registers, so both a and b are accessed in runs of four
+ *       contiguous elements.
+ */
+void rotate_block(const int* a,
+                  int* b,
+                  const size_t n,
+                  const size_t i0,
+                  const size_t i1,
+                  const size_t j0,
+                  const size_t j1,
+                  const bool clockwise)
+{
+    if (i1 - i0 > block_size && i1 - i0 >= j1 - j0)
+    {
+        size_t mid = split_point(i0, i1);
+        rotate_block(a, b, n, i0, mid, j0, j1, clockwise);
+        rotate_block(a, b, n, mid, i1, j0, j1, clockwise);
+        return;
+    }
+    if (j1 - j0 > block_size)
+    {
+        size_t mid = split_point(j0, j1);
+        rotate_block(a, b, n, i0, i1, j0, mid, clockwise);
+        rotate_block(a, b, n, i0, i1, mid, j1, clockwise);
+        return;
+    }
+
+    const ptrdiff_t stride = n;
+
+    for (size_t i = i0; i < i1; i += 4)
+    {
+        for (size_t j = j0; j < j1; j += 4)
+        {
+            if (i + 4 <= i1 && j + 4 <= j1)
+            {
+                tile t;
+                t.load(a + i * n + j, stride);
+                t.transpose();
+
+                if (clockwise)
+                {
+                    /* (i+r,j+c) --> (j+c,n-1-i-r) */
+                    t.reverse_rows();
+                    t.store(b + j * n + (n - 4 - i), stride);
+                }
+                else
+                {
+                    /* (i+r,j+c) --> (n-1-j-c,i+r) */
+                    t.store(b + (n - 1 - j) * n + i, -stride);
+                }
+                continue;
+            }
+
+            /* the tile is cut off by the last row or column */
+            for (size_t r = i; r < std::min(i + 4, i1); ++r)
+            {
+                for (size_t c = j; c < std::min(j + 4, j1); ++c)
+                {
+                    if (clockwise)
+                    {
+                        b[c * n + (n - 1 - r)] = a[r * n + c];
+                    }
+                    else
+                    {
+                        b[(n - 1 - c) * n + r] = a[r * n + c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Cache-oblivious solution which requires the matrix to be copied.
+ * @return A copy of the input matrix rotated in the given direction.
+ * @note Complexity: O(n²) in time, O(n²) in space, where n is the matrix size.
+ *       The number of cache misses is O(n²/L) for a cache line of L elements
+ *       (rotate_square_matrix_1 incurs O(n²) misses once a column of the
+ *       output no longer fits in the cache).
+ */
+square_matrix rotate_square_matrix_3(
+    const square_matrix& A,
+    const rotation direction = rotation::counterclockwise)
+{
+    size_t n = A.size();
+
+    square_matrix A_rot(n);
+
+    if (direction == rotation::half_turn)
+    {
+        /* (i,j) --> (n-1-i,n-1-j) reverses the sequence of elements */
+        std::reverse_copy(A.data(), A.data() + n * n, A_rot.data());
+    }
+    else
+    {
+        rotate_block(A.data(),
+                     A_rot.data(),
+                     n,
+                     0,
+                     n,
+                     0,
+                     n,
+                     direction == rotation::clockwise);
+    }
+
+    return A_rot;
+}
+
+/**
+ * @brief Swaps the block [i0,i1)×[j0,j1) of the n×n matrix a with the
+ *        transpose of the block [j0,j1)×[i0,i1) (the blocks must not overlap).
+ * @note Like rotate_block, this recursion is cache-oblivious and moves 4×4
+ *       tiles through registers.
+ */
+void swap_transposed_blocks(int* a,
+                            const size_t n,
+                            const size_t i0,
+                            const size_t i1,
+                            const size_t j0,
+                            const size_t j1)
+{
+    if (i1 - i0 > block_size && i1 - i0 >= j1 - j0)
+    {
+        size_t mid = split_point(i0, i1);
+        swap_transposed_blocks(a, n, i0, mid, j0, j1);
+        swap_transposed_blocks(a, n, mid, i1, j0, j1);
+        return;
+    }
+    if (j1 - j0 > block_size)
+    {
+        size_t mid = split_point(j0, j1);
+        swap_transposed_blocks(a, n, i0, i1, j0, mid);
+        swap_transposed_blocks(a, n, i0, i1, mid, j1);
+        return;
+    }
+
+    const ptrdiff_t stride = n;
+
+    for (size_t i = i0; i < i1; i += 4)
+    {
+        for (size_t j = j0; j < j1; j += 4)
+        {
+            if (i + 4 <= i1 && j + 4 <= j1)
+            {
+                tile p;
+                tile q;
+
+                p.load(a + i * n + j, stride);
+                q.load(a + j * n + i, stride);
+                p.transpose();
+                q.transpose();
+                p.store(a + j * n + i, stride);
+                q.store(a + i * n + j, stride);
+                continue;
+            }
+
+            /* the tile is cut off by the last row or column */
+            for (size_t r = i; r < std::min(i + 4, i1); ++r)
+            {
+                for (size_t c = j; c < std::min(j + 4, j1); ++c)
+                {
+                    std::swap(a[r * n + c], a[c * n + r]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Transposes the diagonal block [i0,i1)×[i0,i1) of the n×n matrix a
+ *        in place.
+ */
+void transpose_block(int* a, const size_t n, const size_t i0, const size_t i1)
+{
+    if (i1 - i0 > block_size)
+    {
+        size_t mid = split_point(i0, i1);
+        transpose_block(a, n, i0, mid);
+        transpose_block(a, n, mid, i1);
+        swap_transposed_blocks(a, n, i0, mid, mid, i1);
+        return;
+    }
+
+    for (size_t i = i0; i < i1; ++i)
+    {
+        for (size_t j = i + 1; j < i1; ++j)
+        {
+            std::swap(a[i * n + j], a[j * n + i]);
+        }
+    }
+}
+
+/**
+ * @brief Cache-oblivious solution which rotates the matrix in place.
+ * @return A reference to the input matrix (rotated in the given direction).
+ * @note Complexity: O(n²) in time, O(log(n)) in space (recursion depth), where
+ *       n is the matrix size.
+ * @note A 90-degree rotation is a transposition followed by a reflection: the
+ *       transposition is done by recursive tiling, and the reflection either
+ *       swaps whole rows (counterclockwise) or reverses each row (clockwise),
+ *       so that it only accesses contiguous memory.
+ */
+square_matrix& rotate_square_matrix_4(
+    square_matrix& A, const rotation direction = rotation::counterclockwise)
+{
+    size_t n = A.size();
+    int* a = A.data();
+
+    if (direction == rotation::half_turn)
+    {
+        /* (i,j) --> (n-1-i,n-1-j) reverses the sequence of elements */
+        std::reverse(a, a + n * n);
+        return A;
+    }
+
+    /* (i,j) --> (j,i) */
+    transpose_block(a, n, 0, n);
+
+    if (direction == rotation::counterclockwise)
+    {
+        /* (j,i) --> (n-1-j,i) */
+        for (size_t i = 0; i < n / 2; ++i)
+        {
+            std::swap_ranges(a + i * n, a + (i + 1) * n, a + (n - 1 - i) * n);
+        }
+    }
+    else
+    {
+        /* (j,i) --> (j,n-1-i) */
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::reverse(a + i * n, a + (i + 1) * n);
+        }
+    }
+
+    return A;
+}
+
 /**
  * @brief Generates a random n×n matrix.
  * @note Complexity: O(n²) in both time and space.
@@ -141,6 +510,98 @@ square_matrix random_matrix(const size_t n)
     return A;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * Each matrix element is counted as read once and written once; the
+ * out-of-place rotations include allocating the rotated matrix.
+ */
+
+template<typename Function>
+void bench_rotate(benchmark::state& state, Function rotate)
+{
+    square_matrix A = random_matrix(state.size());
+
+    while (state.keep_running())
+    {
+        rotate(A);
+        benchmark::clobber_memory();
+    }
+
+    state.set_bytes_processed(2.0 * sizeof(int) * A.size() * A.size());
+}
+
+void bench_rotate_square_matrix_1(benchmark::state& state)
+{
+    bench_rotate(state,
+                 [](square_matrix& A) { A = rotate_square_matrix_1(A); });
+}
+
+void bench_rotate_square_matrix_2(benchmark::state& state)
+{
+    bench_rotate(state, rotate_square_matrix_2);
+}
+
+void bench_rotate_out_of_place(benchmark::state& state,
+                               const rotation direction)
+{
+    bench_rotate(state, [direction](square_matrix& A) {
+        A = rotate_square_matrix_3(A, direction);
+    });
+}
+
+void bench_rotate_in_place(benchmark::state& state, const rotation direction)
+{
+    bench_rotate(state, [direction](square_matrix& A) {
+        rotate_square_matrix_4(A, direction);
+    });
+}
+
+void bench_rotate_square_matrix_3_ccw(benchmark::state& state)
+{
+    bench_rotate_out_of_place(state, rotation::counterclockwise);
+}
+
+void bench_rotate_square_matrix_3_cw(benchmark::state& state)
+{
+    bench_rotate_out_of_place(state, rotation::clockwise);
+}
+
+void bench_rotate_square_matrix_3_half_turn(benchmark::state& state)
+{
+    bench_rotate_out_of_place(state, rotation::half_turn);
+}
+
+void bench_rotate_square_matrix_4_ccw(benchmark::state& state)
+{
+    bench_rotate_in_place(state, rotation::counterclockwise);
+}
+
+void bench_rotate_square_matrix_4_cw(benchmark::state& state)
+{
+    bench_rotate_in_place(state, rotation::clockwise);
+}
+
+void bench_rotate_square_matrix_4_half_turn(benchmark::state& state)
+{
+    bench_rotate_in_place(state, rotation::half_turn);
+}
+
+const std::vector<size_t> sizes = benchmark::range(256, 16384);
+
+REGISTER_BENCHMARK(bench_rotate_square_matrix_1, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_2, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_3_ccw, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_3_cw, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_3_half_turn, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_4_ccw, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_4_cw, sizes);
+REGISTER_BENCHMARK(bench_rotate_square_matrix_4_half_turn, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 50; ++n)
@@ -150,6 +611,18 @@ int main()
             square_matrix A = random_matrix(n);
 
             square_matrix A_rot = rotate_square_matrix_1(A);
+            square_matrix A_half = rotate_square_matrix_1(A_rot);
+            square_matrix A_cw = rotate_square_matrix_1(A_half);
+
+            assert(rotate_square_matrix_3(A) == A_rot);
+            assert(rotate_square_matrix_3(A, rotation::clockwise) == A_cw);
+            assert(rotate_square_matrix_3(A, rotation::half_turn) == A_half);
+
+            square_matrix B = A;
+            assert(rotate_square_matrix_4(B, rotation::clockwise) == A_cw);
+            assert(rotate_square_matrix_4(B, rotation::half_turn) == A_rot);
+            assert(rotate_square_matrix_4(B) == A_half);
+
             rotate_square_matrix_2(A);
 
             assert(A == A_rot);
@@ -161,3 +634,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
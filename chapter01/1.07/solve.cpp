@@ -3,12 +3,22 @@
  *       make all elements in the i-th row and the j-th column equal to zero.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 class matrix
 {
 public:
@@ -39,6 +49,11 @@ public:
         return n_;
     }
 
+    int* data()
+    {
+        return values_.data();
+    }
+
     bool operator==(const matrix& B) const
     {
         return (m_ == B.m_) && (values_ == B.values_);
@@ -126,6 +141,146 @@ matrix zero_when_necessary_2(matrix& A)
     return A;
 }
 
+/** @brief A fixed-size set of bits stored as an array of 64-bit words. */
+typedef std::vector<uint64_t> bitset;
+
+/**
+ * @brief Splits the rows [0,m) into (at most) k contiguous ranges of nearly
+ *        equal sizes and returns the first row of each range (plus m).
+ */
+std::vector<size_t> split_rows(const size_t m, const size_t k)
+{
+    std::vector<size_t> bounds;
+
+    for (size_t t = 0; t <= k; ++t)
+    {
+        bounds.push_back(m * t / k);
+    }
+
+    return bounds;
+}
+
+/**
+ * @brief Parallel solution which zeroes the relevant rows/columns in place.
+ * @param num_threads The number of threads to use (default: one per core).
+ * @return A reference to the input matrix (with rows/columns zeroed out).
+ * @note Complexity: O(m*n/p) in time, O(p*(m+n)) in space, where p is the
+ *       number of threads.
+ * @note Step 1 splits the rows across the threads, and each thread marks the
+ *       rows and columns which have zeros in its own bitsets (so no
+ *       synchronization is needed). After the column bitsets are merged,
+ *       step 2 splits the rows across the threads again: rows which have
+ *       zeros are cleared with memset, and on the other rows only the 64-bit
+ *       words of the column bitset which are not zero are examined, i.e.,
+ *       columns are zeroed in strips of 64 elements (four cache lines).
+ */
+matrix& zero_when_necessary_3(
+    matrix& A, size_t num_threads = std::thread::hardware_concurrency())
+{
+    size_t m = A.num_rows();
+    size_t n = A.num_cols();
+    int* values = A.data();
+
+    num_threads = std::max<size_t>(1, std::min(num_threads, m));
+
+    std::vector<size_t> bounds = split_rows(m, num_threads);
+
+    size_t row_words = (m + 63) / 64;
+    size_t col_words = (n + 63) / 64;
+
+    std::vector<bitset> row_has_zero(num_threads, bitset(row_words));
+    std::vector<bitset> col_has_zero(num_threads, bitset(col_words));
+
+    /* step 1: find out which rows/columns have zeros */
+    auto find_zeros = [&](const size_t t) {
+        bitset& rows = row_has_zero[t];
+        bitset& cols = col_has_zero[t];
+
+        for (size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+        {
+            const int* row = values + i * n;
+            bool has_zero = false;
+
+            for (size_t j = 0; j < n; ++j)
+            {
+                if (row[j] == 0)
+                {
+                    cols[j / 64] |= uint64_t{1} << (j % 64);
+                    has_zero = true;
+                }
+            }
+
+            if (has_zero)
+            {
+                rows[i / 64] |= uint64_t{1} << (i % 64);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t t = 1; t < num_threads; ++t)
+    {
+        threads.emplace_back(find_zeros, t);
+    }
+    find_zeros(0);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+
+    /* merge the column bitsets (each row is marked by exactly one thread) */
+    bitset& cols = col_has_zero[0];
+
+    for (size_t t = 1; t < num_threads; ++t)
+    {
+        for (size_t w = 0; w < col_words; ++w)
+        {
+            cols[w] |= col_has_zero[t][w];
+        }
+    }
+
+    /* step 2: zero out the rows/columns which have zeros */
+    auto zero_out = [&](const size_t t) {
+        const bitset& rows = row_has_zero[t];
+
+        for (size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+        {
+            int* row = values + i * n;
+
+            if (rows[i / 64] & (uint64_t{1} << (i % 64)))
+            {
+                std::memset(row, 0, n * sizeof(int));
+                continue;
+            }
+
+            for (size_t w = 0; w < col_words; ++w)
+            {
+                /* zero the marked columns in the strip [64*w, 64*w+64) */
+                for (uint64_t bits = cols[w]; bits != 0; bits &= bits - 1)
+                {
+                    row[64 * w + __builtin_ctzll(bits)] = 0;
+                }
+            }
+        }
+    };
+
+    for (size_t t = 1; t < num_threads; ++t)
+    {
+        threads.emplace_back(zero_out, t);
+    }
+    zero_out(0);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    return A;
+}
+
 /**
  * @brief Generates a random m×n matrix.
  * @note Complexity: O(m*n) in both time and space.
@@ -150,6 +305,101 @@ matrix random_matrix(const size_t m, const size_t n)
     return A;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The n×n matrices have n zeros at random positions; each solution is run on
+ * a fresh copy of the matrix (the parallel solution with 1, 2, 4, ... threads
+ * up to the number of cores).
+ */
+
+template<typename Function>
+void bench_zero(benchmark::state& state, Function zero_when_necessary)
+{
+    const size_t n = state.size();
+
+    std::random_device device;
+    std::mt19937 generator(device());
+    std::uniform_int_distribution<size_t> distribution(0, n * n - 1);
+
+    matrix A(n, n);
+    std::fill(A.data(), A.data() + n * n, 1);
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        A.data()[distribution(generator)] = 0;
+    }
+
+    matrix B = A;
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        B = A;
+        state.resume_timing();
+
+        zero_when_necessary(B);
+        benchmark::clobber_memory();
+    }
+
+    state.set_bytes_processed(sizeof(int) * n * n);
+}
+
+void bench_zero_when_necessary_1(benchmark::state& state)
+{
+    bench_zero(state, [](matrix& B) { B = zero_when_necessary_1(B); });
+}
+
+void bench_zero_when_necessary_2(benchmark::state& state)
+{
+    bench_zero(state, [](matrix& B) { zero_when_necessary_2(B); });
+}
+
+template<size_t num_threads>
+void bench_zero_when_necessary_3(benchmark::state& state)
+{
+    bench_zero(state,
+               [](matrix& B) { zero_when_necessary_3(B, num_threads); });
+}
+
+const std::vector<size_t> sizes = benchmark::range(1024, 32768);
+
+REGISTER_BENCHMARK(bench_zero_when_necessary_1, sizes);
+REGISTER_BENCHMARK(bench_zero_when_necessary_2, sizes);
+
+/*
+ * the number of cores is only known at run time, so the parallel solution is
+ * registered as "bench_zero_when_necessary_3/p" for each power of two p up
+ * to it (and at most 256)
+ */
+const bool thread_sweep_registered = [] {
+    void (*const benchmarks[])(benchmark::state&) = {
+        bench_zero_when_necessary_3<1>,
+        bench_zero_when_necessary_3<2>,
+        bench_zero_when_necessary_3<4>,
+        bench_zero_when_necessary_3<8>,
+        bench_zero_when_necessary_3<16>,
+        bench_zero_when_necessary_3<32>,
+        bench_zero_when_necessary_3<64>,
+        bench_zero_when_necessary_3<128>,
+        bench_zero_when_necessary_3<256>};
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0, p = 1; i < 9 && p <= cores; ++i, p *= 2)
+    {
+        const std::string name =
+            "bench_zero_when_necessary_3/" + std::to_string(p);
+        benchmark::registration(name.c_str(), benchmarks[i], sizes);
+    }
+
+    return true;
+}();
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t m = 0; m <= 20; ++m)
@@ -161,6 +411,12 @@ int main()
                 matrix A = random_matrix(m, n);
 
                 matrix A_zero = zero_when_necessary_1(A);
+
+                matrix B = A;
+                /* spawning threads is slow, so only some tests use them */
+                zero_when_necessary_3(B, (i < 100) ? 4 : 1);
+                assert(B == A_zero);
+
                 zero_when_necessary_2(A);
 
                 assert(A == A_zero);
@@ -173,3 +429,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
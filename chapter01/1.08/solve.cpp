@@ -8,9 +8,22 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <stdexcept>
+#include <string>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /**
  * @brief Solution which checks if str2 appears in (str1 + str1).
@@ -53,6 +66,190 @@ bool is_rotation_2(std::string str1, const std::string& str2)
     return result;
 }
 
+/**
+ * @brief Computes the starting position of the lexicographically least
+ *        rotation of the sequence [first, first+n).
+ * @note Complexity: O(n) in time, O(1) in space.
+ * @note Two candidate starting positions i and j are compared by the length k
+ *       of their common prefix; on a mismatch, every start in [i, i+k] (or
+ *       [j, j+k]) is beaten by a corresponding start of the other candidate,
+ *       so it can be skipped. Each step advances i, j or k, and neither
+ *       exceeds n, hence the linear bound (no failure table is needed).
+ */
+template<typename Iterator>
+size_t least_rotation(const Iterator first, const size_t n)
+{
+    size_t i = 0;
+    size_t j = 1;
+    size_t k = 0;
+
+    while (i < n && j < n && k < n)
+    {
+        size_t a = i + k < n ? i + k : i + k - n;
+        size_t b = j + k < n ? j + k : j + k - n;
+
+        unsigned char x = first[a];
+        unsigned char y = first[b];
+
+        if (x == y)
+        {
+            ++k;
+            continue;
+        }
+
+        if (x > y)
+        {
+            i += k + 1;
+        }
+        else
+        {
+            j += k + 1;
+        }
+
+        if (i == j)
+        {
+            ++j;
+        }
+        k = 0;
+    }
+
+    return std::min(i, j);
+}
+
+/**
+ * @brief Determines if the sequence [first2, first2+n) is a rotation of the
+ *        sequence [first1, first1+n) by comparing their least rotations.
+ * @note Complexity: O(n) in time, O(1) in space.
+ */
+template<typename Iterator>
+bool is_rotation(const Iterator first1, const Iterator first2, const size_t n)
+{
+    size_t r1 = least_rotation(first1, n);
+    size_t r2 = least_rotation(first2, n);
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        if (first1[r1] != first2[r2])
+        {
+            return false;
+        }
+
+        r1 = (r1 + 1 == n) ? 0 : r1 + 1;
+        r2 = (r2 + 1 == n) ? 0 : r2 + 1;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Solution which compares the least rotations of str1 and str2.
+ * @return true if str2 is a rotation of str1, false otherwise.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the length of
+ *       the strings (if not the same, one cannot be a rotation of the other).
+ *       Unlike is_rotation_1, the worst case is linear and (str1 + str1) is
+ *       never built.
+ */
+bool is_rotation_3(const std::string& str1, const std::string& str2)
+{
+    if (str1.size() != str2.size())
+    {
+        return false;
+    }
+
+    return is_rotation(str1.begin(), str2.begin(), str1.size());
+}
+
+/** @brief A read-only memory mapping of a whole file. */
+class mapped_file
+{
+public:
+    mapped_file(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd == -1)
+        {
+            throw std::runtime_error("cannot open file: " + path);
+        }
+
+        struct stat status;
+
+        if (fstat(fd, &status) == -1)
+        {
+            close(fd);
+            throw std::runtime_error("cannot read file size: " + path);
+        }
+
+        size_ = status.st_size;
+
+        /* empty files cannot be mapped (but need not be) */
+        if (size_ > 0)
+        {
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("cannot map file: " + path);
+            }
+
+            data_ = static_cast<const char*>(data);
+
+            /* the pages are read (twice) in order */
+            madvise(data, size_, MADV_SEQUENTIAL);
+        }
+
+        close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file()
+    {
+        if (data_ != nullptr)
+        {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Determines if the contents of a file are a rotation of the contents
+ *        of another file.
+ * @return true if the contents of path2 are a rotation of the contents of
+ *         path1, false otherwise.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the file size.
+ *       The files are memory-mapped, so the only memory used is the page
+ *       cache (files of any size can be compared).
+ */
+bool is_rotation_of_file(const std::string& path1, const std::string& path2)
+{
+    mapped_file file1(path1);
+    mapped_file file2(path2);
+
+    if (file1.size() != file2.size())
+    {
+        return false;
+    }
+
+    return is_rotation(file1.data(), file2.data(), file1.size());
+}
+
 /**
  * @brief Generates a random ASCII string of length n and characters in [a-c].
  * @note Complexity: O(n) in both time and space.
@@ -74,6 +271,54 @@ std::string random_string(const size_t n)
     return str;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The strings are "aa...ab" and its rotation "ab...aa", which make searching
+ * for str2 in (str1 + str1) quadratic; the quadratic solutions are only run
+ * for strings of up to 64 KB.
+ */
+
+template<typename Function>
+void bench_is_rotation(benchmark::state& state, Function is_rotation)
+{
+    std::string str1(state.size() - 1, 'a');
+    str1.push_back('b');
+
+    std::string str2 = str1;
+    std::rotate(str2.begin(), str2.end() - 2, str2.end());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(is_rotation(str1, str2));
+    }
+
+    state.set_bytes_processed(str1.size());
+}
+
+void bench_is_rotation_1(benchmark::state& state)
+{
+    bench_is_rotation(state, is_rotation_1);
+}
+
+void bench_is_rotation_2(benchmark::state& state)
+{
+    bench_is_rotation(state, is_rotation_2);
+}
+
+void bench_is_rotation_3(benchmark::state& state)
+{
+    bench_is_rotation(state, is_rotation_3);
+}
+
+REGISTER_BENCHMARK(bench_is_rotation_1, benchmark::range(16, 1 << 16, 4));
+REGISTER_BENCHMARK(bench_is_rotation_2, benchmark::range(16, 1 << 16, 4));
+REGISTER_BENCHMARK(bench_is_rotation_3, benchmark::range(16, 1 << 26, 4));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 20; ++n)
@@ -83,7 +328,10 @@ int main()
             std::string str1 = random_string(n);
             std::string str2 = random_string(n);
 
-            assert(is_rotation_1(str1, str2) == is_rotation_2(str1, str2));
+            bool result = is_rotation_2(str1, str2);
+
+            assert(is_rotation_1(str1, str2) == result);
+            assert(is_rotation_3(str1, str2) == result);
 
             for (size_t j = 0; j < n; ++j)
             {
@@ -93,6 +341,7 @@ int main()
 
                 assert(is_rotation_1(str1, str1_rot) == true);
                 assert(is_rotation_2(str1, str1_rot) == true);
+                assert(is_rotation_3(str1, str1_rot) == true);
             }
         }
 
@@ -100,5 +349,36 @@ int main()
                   << std::endl;
     }
 
+    const std::string path1 = "input-file-1.txt";
+    const std::string path2 = "input-file-2.txt";
+
+    for (size_t n = 0; n <= 20; ++n)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            std::string str1 = random_string(n);
+            std::string str2 = (i % 2 == 0) ? random_string(n) : str1;
+
+            if (n > 0)
+            {
+                std::rotate(str2.begin(), str2.begin() + i % n, str2.end());
+            }
+
+            std::ofstream(path1, std::ios::binary) << str1;
+            std::ofstream(path2, std::ios::binary) << str2;
+
+            assert(is_rotation_of_file(path1, path2) ==
+                   is_rotation_2(str1, str2));
+        }
+
+        std::cout << "passed file tests for strings of length " << n
+                  << std::endl;
+    }
+
+    std::remove(path1.c_str());
+    std::remove(path2.c_str());
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -1,10 +1,256 @@
 #ifndef __LIST_HPP__
 #define __LIST_HPP__
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <thread>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
-/** @brief A singly-linked list. */
+/**
+ * @brief Node allocation policy which allocates each node separately on the
+ *        heap (and frees each node separately as well).
+ */
+template<typename Node>
+class heap_allocator
+{
+public:
+    /* nodes must be freed one by one */
+    static constexpr bool releases_in_bulk = false;
+
+    Node* allocate()
+    {
+        return static_cast<Node*>(::operator new(sizeof(Node)));
+    }
+
+    void deallocate(Node* p)
+    {
+        ::operator delete(p);
+    }
+};
+
+/**
+ * @brief Node allocation policy which carves nodes out of contiguous chunks of
+ *        memory (so that consecutively inserted nodes are adjacent in memory)
+ *        and recycles freed nodes through a free list. All chunks are released
+ *        at once when the allocator is destroyed.
+ * @note Chunk sizes double up to max_chunk_size nodes, so a pool holding n
+ *       nodes owns O(log(max_chunk_size) + n/max_chunk_size) chunks.
+ */
+template<typename Node>
+class pool_allocator
+{
+public:
+    /* the memory of all nodes is released by the allocator's destructor */
+    static constexpr bool releases_in_bulk = true;
+
+    static constexpr size_t min_chunk_size = 64;
+    static constexpr size_t max_chunk_size = 65536;
+
+    pool_allocator() = default;
+
+    pool_allocator(const pool_allocator&) = delete;
+    pool_allocator& operator=(const pool_allocator&) = delete;
+
+    /**
+     * @brief Destructor.
+     * @note Complexity: O(c) in time, O(1) in space, where c is the number of
+     *       allocated chunks.
+     */
+    ~pool_allocator()
+    {
+        for (slot* chunk : chunks_)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    /**
+     * @brief Returns memory for a single node.
+     * @note Complexity: O(1) in time (amortized), O(1) in space.
+     */
+    Node* allocate()
+    {
+        if (free_list_ != nullptr)
+        {
+            slot* recycled = free_list_;
+            free_list_ = free_list_->next;
+            return reinterpret_cast<Node*>(recycled);
+        }
+
+        if (next_ == end_)
+        {
+            const size_t chunk_size =
+                chunks_.empty()
+                    ? min_chunk_size
+                    : std::min(2 * chunk_size_, size_t{max_chunk_size});
+
+            chunks_.push_back(
+                static_cast<slot*>(::operator new(chunk_size * sizeof(slot))));
+
+            chunk_size_ = chunk_size;
+            next_ = chunks_.back();
+            end_ = next_ + chunk_size;
+        }
+
+        return reinterpret_cast<Node*>(next_++);
+    }
+
+    /**
+     * @brief Returns the memory of a node to the pool.
+     * @note Complexity: O(1) in both time and space.
+     */
+    void deallocate(Node* p)
+    {
+        slot* freed = reinterpret_cast<slot*>(p);
+        freed->next = free_list_;
+        free_list_ = freed;
+    }
+
+private:
+    /** @brief Storage for a node, or a link of the free list. */
+    union slot
+    {
+        slot* next;
+        typename std::aligned_storage<sizeof(Node), alignof(Node)>::type node;
+    };
+
+    std::vector<slot*> chunks_;
+    size_t chunk_size_ = 0;
+
+    /* the unused part of the last chunk */
+    slot* next_ = nullptr;
+    slot* end_ = nullptr;
+
+    slot* free_list_ = nullptr;
+};
+
+/**
+ * @brief Mixes the bits of a hash value so that all of them affect the low
+ *        bits (std::hash is the identity function for integers).
+ */
+inline size_t mix_hash(const size_t hash)
+{
+    uint64_t h = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+/**
+ * @brief A hash set with open addressing (linear probing) whose capacity is
+ *        fixed on construction to at least twice the maximum number of values
+ *        it will hold, so it never rehashes and its load factor stays <= 1/2.
+ * @note Values are stored in a single contiguous array (instead of in one
+ *       allocated node per value as in std::unordered_set).
+ */
+template<typename T>
+class flat_hash_set
+{
+public:
+    explicit flat_hash_set(const size_t max_size)
+    {
+        size_t capacity = 16;
+
+        while (capacity < 2 * max_size)
+        {
+            capacity *= 2;
+        }
+
+        values_.resize(capacity);
+        used_.resize(capacity, 0);
+        mask_ = capacity - 1;
+    }
+
+    /** @brief Returns the (mixed) hash of a value. */
+    static size_t hash(const T& value)
+    {
+        return mix_hash(std::hash<T>{}(value));
+    }
+
+    /**
+     * @brief Inserts a value whose hash is given.
+     * @return true if the value was inserted, false if it was already present.
+     * @note Complexity: O(1) in both time and space (on average).
+     */
+    bool insert(const T& value, const size_t hash)
+    {
+        size_t i = hash & mask_;
+
+        while (used_[i] != 0)
+        {
+            if (values_[i] == value)
+            {
+                return false;
+            }
+            i = (i + 1) & mask_;
+        }
+
+        used_[i] = 1;
+        values_[i] = value;
+
+        return true;
+    }
+
+    bool insert(const T& value)
+    {
+        return insert(value, hash(value));
+    }
+
+private:
+    std::vector<T> values_;
+    std::vector<uint8_t> used_;
+    size_t mask_;
+};
+
+/** @brief A set of integers in [min,max] with one bit per possible value. */
 template<typename T>
+class bitmap_set
+{
+public:
+    bitmap_set(const T min, const T max)
+        : min_(min), bits_(range(min, max) / 64 + 1, 0)
+    {
+        /* nothing needs to be done here */
+    }
+
+    /** @brief Returns max - min without overflowing (also for signed T). */
+    static uint64_t range(const T min, const T max)
+    {
+        return static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    }
+
+    /**
+     * @brief Inserts a value in [min,max].
+     * @return true if the value was inserted, false if it was already present.
+     * @note Complexity: O(1) in both time and space.
+     */
+    bool insert(const T value)
+    {
+        const uint64_t offset = range(min_, value);
+        const uint64_t bit = uint64_t{1} << (offset % 64);
+
+        if (bits_[offset / 64] & bit)
+        {
+            return false;
+        }
+        bits_[offset / 64] |= bit;
+
+        return true;
+    }
+
+private:
+    T min_;
+    std::vector<uint64_t> bits_;
+};
+
+/**
+ * @brief A singly-linked list.
+ * @note The Allocator policy determines how the list nodes are allocated.
+ */
+template<typename T, template<typename> class Allocator = heap_allocator>
 class list
 {
 private:
@@ -19,17 +265,25 @@ public:
     /**
      * @brief Destructor.
      * @note Complexity: O(n) in time, O(1) in space, where n is the number
-     *       of nodes in the list.
+     *       of nodes in the list (if the allocator releases all nodes at once
+     *       and T is trivially destructible, the nodes are not visited).
      */
     ~list()
     {
+        /* the allocator releases the memory of all nodes at once */
+        if (Allocator<node>::releases_in_bulk &&
+            std::is_trivially_destructible<T>::value)
+        {
+            return;
+        }
+
         node* position = head_;
 
         while (position != nullptr)
         {
             node* node_to_delete = position;
             position = position->next_;
-            delete node_to_delete;
+            destroy_node(node_to_delete);
         }
     }
 
@@ -41,7 +295,7 @@ public:
     void insert(const T& value)
     {
         node* old_head = head_;
-        head_ = new node;
+        head_ = create_node();
         head_->value_ = value;
         head_->next_ = old_head;
 
@@ -81,7 +335,7 @@ public:
             {
                 node* node_to_delete = position->next_;
                 position->next_ = position->next_->next_;
-                delete node_to_delete;
+                destroy_node(node_to_delete);
 
                 ++removed;
                 --size_;
@@ -128,7 +382,7 @@ public:
                 {
                     node* node_to_delete = position->next_;
                     position->next_ = position->next_->next_;
-                    delete node_to_delete;
+                    destroy_node(node_to_delete);
 
                     ++removed;
                     --size_;
@@ -148,6 +402,166 @@ public:
         return removed;
     }
 
+    /**
+     * @brief Removes duplicates using a flat hash set or, if T is an integral
+     *        type whose values in the list span a small enough range, a
+     *        bitmap with one bit per value in that range.
+     * @note Complexity: O(n) in both time and space, where n is the number
+     *       of nodes in the list.
+     * @note Unlike remove_duplicates_1, no memory is allocated per distinct
+     *       value: the seen-set is allocated once with room for all n values.
+     * @return The number of removed nodes.
+     */
+    size_t remove_duplicates_3()
+    {
+        /* a list needs at least two elements for any removal to occur */
+        if (size() <= 1)
+        {
+            return 0;
+        }
+
+        return remove_duplicates_3(std::is_integral<T>{});
+    }
+
+    /**
+     * @brief Parallel version of remove_duplicates_3: values are partitioned
+     *        by their hashes, and each thread finds the duplicates of the
+     *        values in its own partition with its own flat hash set.
+     * @param num_threads The number of threads to use (default: one per core).
+     * @note Complexity: O(n/p + p^2) in time (plus O(n) for the list
+     *       traversals, which cannot be split), O(n + p^2) in space, where p
+     *       is the number of threads.
+     * @note Step 1 collects the nodes into an array (so the threads can index
+     *       them); each thread then hashes the values in its own chunk of the
+     *       array and counts how many of them fall into each partition. Step 2
+     *       turns these counts into bucket offsets (prefix sums), and each
+     *       thread scatters the indices of its chunk into the per-partition
+     *       buckets; since chunks are in list order, so are the buckets. In
+     *       step 3, each thread walks only its own bucket and inserts its
+     *       values into its set, so equal values always meet in the same set
+     *       and the first occurrence of each value is kept. Step 4 relinks
+     *       the surviving nodes in their original order.
+     * @return The number of removed nodes.
+     */
+    size_t remove_duplicates_parallel(
+        size_t num_threads = std::thread::hardware_concurrency())
+    {
+        num_threads = std::max<size_t>(1, std::min(num_threads, size()));
+
+        if (num_threads == 1)
+        {
+            return remove_duplicates_3();
+        }
+
+        std::vector<node*> nodes;
+        nodes.reserve(size());
+
+        for (node* position = head_; position != nullptr;
+             position = position->next_)
+        {
+            nodes.push_back(position);
+        }
+
+        const size_t n = nodes.size();
+
+        std::vector<size_t> hashes(n);
+        std::vector<size_t> buckets(n);
+        std::vector<uint8_t> is_duplicate(n, 0);
+
+        /* counts[t * num_threads + p]: values of chunk t in partition p */
+        std::vector<size_t> counts(num_threads * num_threads, 0);
+
+        /* bucket p occupies buckets[bucket_begin[p], bucket_begin[p + 1]) */
+        std::vector<size_t> bucket_begin(num_threads + 1, 0);
+
+        auto chunk_begin = [&](const size_t t) { return n * t / num_threads; };
+
+        /* the partition is taken from the high bits (the set uses the low) */
+        auto partition = [&](const size_t hash) {
+            return (hash >> (4 * sizeof(size_t))) % num_threads;
+        };
+
+        /* step 1: hash the values and count them per partition */
+        auto hash_values = [&](const size_t t) {
+            size_t* chunk_counts = &counts[t * num_threads];
+
+            for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i)
+            {
+                hashes[i] = flat_hash_set<T>::hash(nodes[i]->value_);
+                ++chunk_counts[partition(hashes[i])];
+            }
+        };
+
+        /* step 2: scatter the node indices into the partition buckets */
+        auto scatter_indices = [&](const size_t t) {
+            size_t* offsets = &counts[t * num_threads];
+
+            for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i)
+            {
+                buckets[offsets[partition(hashes[i])]++] = i;
+            }
+        };
+
+        /* step 3: mark the duplicates in each partition */
+        auto find_duplicates = [&](const size_t p) {
+            flat_hash_set<T> seen(bucket_begin[p + 1] - bucket_begin[p]);
+
+            for (size_t k = bucket_begin[p]; k < bucket_begin[p + 1]; ++k)
+            {
+                const size_t i = buckets[k];
+
+                if (seen.insert(nodes[i]->value_, hashes[i]) == false)
+                {
+                    is_duplicate[i] = 1;
+                }
+            }
+        };
+
+        run_in_parallel(num_threads, hash_values);
+
+        /* turn the counts into the offsets where each chunk starts writing */
+        size_t offset = 0;
+
+        for (size_t p = 0; p < num_threads; ++p)
+        {
+            bucket_begin[p] = offset;
+
+            for (size_t t = 0; t < num_threads; ++t)
+            {
+                const size_t count = counts[t * num_threads + p];
+                counts[t * num_threads + p] = offset;
+                offset += count;
+            }
+        }
+        bucket_begin[num_threads] = offset;
+
+        run_in_parallel(num_threads, scatter_indices);
+        run_in_parallel(num_threads, find_duplicates);
+
+        /* step 4: relink the surviving nodes (the head is never removed) */
+        size_t removed = 0;
+        node* last = nodes[0];
+
+        for (size_t i = 1; i < n; ++i)
+        {
+            if (is_duplicate[i] != 0)
+            {
+                destroy_node(nodes[i]);
+                ++removed;
+            }
+            else
+            {
+                last->next_ = nodes[i];
+                last = nodes[i];
+            }
+        }
+        last->next_ = nullptr;
+
+        size_ -= removed;
+
+        return removed;
+    }
+
     /** @brief Returns the list size. */
     size_t size() const
     {
@@ -177,9 +591,128 @@ public:
         return result;
     }
 
+    /**
+     * @brief Returns true if both lists hold the same values in the same
+     *        order, false otherwise.
+     * @note Complexity: O(n) in time, O(1) in space, where n is the number
+     *       of nodes in the list.
+     */
+    bool operator==(const list& other) const
+    {
+        node* position = head_;
+        node* other_position = other.head_;
+
+        while (position != nullptr && other_position != nullptr)
+        {
+            if (!(position->value_ == other_position->value_))
+            {
+                return false;
+            }
+            position = position->next_;
+            other_position = other_position->next_;
+        }
+
+        return position == nullptr && other_position == nullptr;
+    }
+
 private:
+    /** @brief remove_duplicates_3 for integral types. */
+    size_t remove_duplicates_3(std::true_type)
+    {
+        T min = head_->value_;
+        T max = head_->value_;
+
+        for (node* position = head_; position != nullptr;
+             position = position->next_)
+        {
+            min = std::min(min, position->value_);
+            max = std::max(max, position->value_);
+        }
+
+        /* use a bitmap if it is not larger than a flat hash set would be */
+        if (bitmap_set<T>::range(min, max) / 64 < size())
+        {
+            bitmap_set<T> seen(min, max);
+            return remove_seen(seen);
+        }
+
+        return remove_duplicates_3(std::false_type{});
+    }
+
+    /** @brief remove_duplicates_3 for all other types. */
+    size_t remove_duplicates_3(std::false_type)
+    {
+        flat_hash_set<T> seen(size());
+        return remove_seen(seen);
+    }
+
+    /** @brief Runs step(t) for every t in [0,num_threads) in parallel. */
+    template<typename Step>
+    static void run_in_parallel(const size_t num_threads, const Step& step)
+    {
+        std::vector<std::thread> threads;
+
+        for (size_t t = 1; t < num_threads; ++t)
+        {
+            threads.emplace_back(step, t);
+        }
+        step(0);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Removes the nodes whose values cannot be inserted into a set
+     *        (i.e., the values which have been seen before).
+     * @return The number of removed nodes.
+     */
+    template<typename Set>
+    size_t remove_seen(Set& seen)
+    {
+        size_t removed = 0;
+
+        node* position = head_;
+        seen.insert(position->value_);
+
+        while (position->next_ != nullptr)
+        {
+            /* if the next value is a duplicate */
+            if (seen.insert(position->next_->value_) == false)
+            {
+                node* node_to_delete = position->next_;
+                position->next_ = position->next_->next_;
+                destroy_node(node_to_delete);
+
+                ++removed;
+                --size_;
+            }
+            else
+            {
+                position = position->next_;
+            }
+        }
+
+        return removed;
+    }
+
+    node* create_node()
+    {
+        return new (allocator_.allocate()) node;
+    }
+
+    void destroy_node(node* p)
+    {
+        p->~node();
+        allocator_.deallocate(p);
+    }
+
     node* head_ = nullptr;
     size_t size_ = 0;
+
+    Allocator<node> allocator_;
 };
 
 #endif /* __LIST_HPP__ */
@@ -6,10 +6,231 @@
 
 #include <cassert>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <set>
+#include <string>
+#include <vector>
 #include "list.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+#ifdef BENCHMARK
+
+/*
+ * The lists have n values drawn from n/2 distinct ones, so roughly half of
+ * their nodes are duplicates; building and destroying the lists is not timed.
+ * The distinct values are either [0, n/2] or (if spread is true) random
+ * integers, which are too spread out for remove_duplicates_3 to use a bitmap.
+ */
+
+template<typename Function>
+void bench_remove_duplicates(benchmark::state& state,
+                             Function remove_duplicates,
+                             const bool spread = false)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<int> distribution(0, state.size() / 2);
+
+    std::vector<int> distinct_values;
+    while (distinct_values.size() <= state.size() / 2)
+    {
+        distinct_values.push_back(spread ? generator()
+                                         : distinct_values.size());
+    }
+
+    std::vector<int> values;
+    while (values.size() < state.size())
+    {
+        values.push_back(distinct_values[distribution(generator)]);
+    }
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        std::unique_ptr<list<int>> L(new list<int>);
+        for (const int value : values)
+        {
+            L->insert(value);
+        }
+        state.resume_timing();
+
+        benchmark::do_not_optimize(remove_duplicates(*L));
+
+        state.pause_timing();
+        L.reset();
+        state.resume_timing();
+    }
+
+    state.set_items_processed(values.size());
+}
+
+void bench_remove_duplicates_1(benchmark::state& state)
+{
+    bench_remove_duplicates(
+        state, [](list<int>& L) { return L.remove_duplicates_1(); });
+}
+
+void bench_remove_duplicates_2(benchmark::state& state)
+{
+    bench_remove_duplicates(
+        state, [](list<int>& L) { return L.remove_duplicates_2(); });
+}
+
+void bench_remove_duplicates_3(benchmark::state& state)
+{
+    bench_remove_duplicates(
+        state, [](list<int>& L) { return L.remove_duplicates_3(); });
+}
+
+void bench_remove_duplicates_3_spread(benchmark::state& state)
+{
+    bench_remove_duplicates(
+        state, [](list<int>& L) { return L.remove_duplicates_3(); }, true);
+}
+
+void bench_remove_duplicates_parallel(benchmark::state& state)
+{
+    bench_remove_duplicates(
+        state, [](list<int>& L) { return L.remove_duplicates_parallel(); });
+}
+
+/* each iteration builds a list with n values, then destroys it */
+template<template<typename> class Allocator>
+void bench_insert_destroy(benchmark::state& state)
+{
+    while (state.keep_running())
+    {
+        list<int, Allocator> L;
+
+        for (size_t i = 0; i < state.size(); ++i)
+        {
+            L.insert(i);
+        }
+
+        benchmark::do_not_optimize(L.size());
+    }
+
+    state.set_items_processed(state.size());
+}
+
+/* each iteration traverses a list with n values */
+template<template<typename> class Allocator>
+void bench_traverse(benchmark::state& state)
+{
+    list<int, Allocator> L;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        L.insert(i);
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(L.count(0));
+    }
+
+    state.set_items_processed(state.size());
+}
+
+void bench_insert_destroy_heap(benchmark::state& state)
+{
+    bench_insert_destroy<heap_allocator>(state);
+}
+
+void bench_insert_destroy_pool(benchmark::state& state)
+{
+    bench_insert_destroy<pool_allocator>(state);
+}
+
+void bench_traverse_heap(benchmark::state& state)
+{
+    bench_traverse<heap_allocator>(state);
+}
+
+void bench_traverse_pool(benchmark::state& state)
+{
+    bench_traverse<pool_allocator>(state);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 26, 4);
+
+/* remove_duplicates_2 is quadratic, so it is only run on shorter lists */
+REGISTER_BENCHMARK(bench_remove_duplicates_1, benchmark::range(16, 1 << 20, 4));
+REGISTER_BENCHMARK(bench_remove_duplicates_2, benchmark::range(16, 1 << 14, 4));
+REGISTER_BENCHMARK(bench_remove_duplicates_3, sizes);
+REGISTER_BENCHMARK(bench_remove_duplicates_3_spread, sizes);
+REGISTER_BENCHMARK(bench_remove_duplicates_parallel, sizes);
+REGISTER_BENCHMARK(bench_insert_destroy_heap, sizes);
+REGISTER_BENCHMARK(bench_insert_destroy_pool, sizes);
+REGISTER_BENCHMARK(bench_traverse_heap, sizes);
+REGISTER_BENCHMARK(bench_traverse_pool, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
+/**
+ * @brief Builds four lists with the given values, removes their duplicates
+ *        using each solution and checks that only the first occurrence of
+ *        each value remains (in the original order).
+ */
+template<typename T, template<typename> class Allocator>
+void check_remove_duplicates(const std::vector<T>& values,
+                             const size_t num_threads)
+{
+    list<T, Allocator> L1;
+    list<T, Allocator> L2;
+    list<T, Allocator> L3;
+    list<T, Allocator> L4;
+
+    /* set of inserted values */
+    std::set<T> S;
+
+    /* L1, L2, L3 and L4 are copies of each other */
+    for (const T& value : values)
+    {
+        L1.insert(value);
+        L2.insert(value);
+        L3.insert(value);
+        L4.insert(value);
+        S.insert(value);
+    }
+
+    assert(L1.size() == L2.size());
+
+    size_t removed_1 = L1.remove_duplicates_1();
+    size_t removed_2 = L2.remove_duplicates_2();
+    size_t removed_3 = L3.remove_duplicates_3();
+    size_t removed_4 = L4.remove_duplicates_parallel(num_threads);
+
+    assert(removed_1 == removed_2);
+    assert(removed_1 == removed_3);
+    assert(removed_1 == removed_4);
+
+    assert(L1.size() == S.size());
+    assert(L2.size() == S.size());
+
+    for (const T& value : S)
+    {
+        assert(L1.count(value) == 1);
+        assert(L2.count(value) == 1);
+    }
+
+    /* all solutions keep the first occurrence of each value */
+    assert(L1 == L2);
+    assert(L1 == L3);
+    assert(L1 == L4);
+
+    /* duplicates were already removed */
+    assert(L1.remove_duplicates_1() == 0);
+    assert(L2.remove_duplicates_2() == 0);
+    assert(L3.remove_duplicates_3() == 0);
+    assert(L4.remove_duplicates_parallel(num_threads) == 0);
+}
+
 int main()
 {
     std::random_device device;
@@ -21,41 +242,54 @@ int main()
         {
             std::uniform_int_distribution<int> distribution(0, n);
 
-            list<int> L1;
-            list<int> L2;
-
-            /* set of inserted values */
-            std::set<int> S;
+            std::vector<int> values;
 
-            /* L1 and L2 are copies of each other */
             for (int k = 0; k < n; ++k)
             {
-                int value = distribution(generator);
-
-                L1.insert(value);
-                L2.insert(value);
-                S.insert(value);
+                values.push_back(distribution(generator));
             }
 
-            assert(L1.size() == L2.size());
+            /*
+             * spawning threads is slow, so only every 20th list is tested
+             * with threads (2, 3 or 4 of them, so the number of partitions
+             * is not always a power of two)
+             */
+            size_t num_threads = (i % 20 == 0) ? 2 + (i / 20) % 3 : 1;
 
-            size_t removed_1 = L1.remove_duplicates_1();
-            size_t removed_2 = L2.remove_duplicates_2();
+            check_remove_duplicates<int, heap_allocator>(values, num_threads);
 
-            assert(removed_1 == removed_2);
+            /* the other allocator variants are only tested on some lists */
+            if (i < 50)
+            {
+                std::vector<std::string> strings;
 
-            assert(L1.size() == S.size());
-            assert(L2.size() == S.size());
+                for (const int value : values)
+                {
+                    strings.push_back(std::to_string(value));
+                }
 
-            for (const int value : S)
-            {
-                assert(L1.count(value) == 1);
-                assert(L2.count(value) == 1);
+                check_remove_duplicates<int, pool_allocator>(values,
+                                                             num_threads);
+
+                /* strings are not trivially destructible */
+                check_remove_duplicates<std::string, pool_allocator>(
+                    strings, num_threads);
             }
 
-            /* duplicates were already removed */
-            assert(L1.remove_duplicates_1() == 0);
-            assert(L2.remove_duplicates_2() == 0);
+            /* spread out values are only tested on some lists */
+            if (i < 100)
+            {
+                std::vector<int> spread_values;
+
+                for (const int value : values)
+                {
+                    /* too spread out for remove_duplicates_3 to use a bitmap */
+                    spread_values.push_back(value * 1000003 - 50000000);
+                }
+
+                check_remove_duplicates<int, heap_allocator>(spread_values,
+                                                             num_threads);
+            }
         }
 
         std::cout << "passed random tests for lists of length " << n
@@ -64,3 +298,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -1,11 +1,136 @@
 #ifndef __LIST_HPP__
 #define __LIST_HPP__
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
 
-/** @brief A singly-linked list. */
-template<typename T>
+/**
+ * @brief Node allocation policy which allocates each node separately on the
+ *        heap (and frees each node separately as well).
+ */
+template<typename Node>
+class heap_allocator
+{
+public:
+    /* nodes must be freed one by one */
+    static constexpr bool releases_in_bulk = false;
+
+    Node* allocate()
+    {
+        return static_cast<Node*>(::operator new(sizeof(Node)));
+    }
+
+    void deallocate(Node* p)
+    {
+        ::operator delete(p);
+    }
+};
+
+/**
+ * @brief Node allocation policy which carves nodes out of contiguous chunks of
+ *        memory (so that consecutively inserted nodes are adjacent in memory)
+ *        and recycles freed nodes through a free list. All chunks are released
+ *        at once when the allocator is destroyed.
+ * @note Chunk sizes double up to max_chunk_size nodes, so a pool holding n
+ *       nodes owns O(log(max_chunk_size) + n/max_chunk_size) chunks.
+ */
+template<typename Node>
+class pool_allocator
+{
+public:
+    /* the memory of all nodes is released by the allocator's destructor */
+    static constexpr bool releases_in_bulk = true;
+
+    static constexpr size_t min_chunk_size = 64;
+    static constexpr size_t max_chunk_size = 65536;
+
+    pool_allocator() = default;
+
+    pool_allocator(const pool_allocator&) = delete;
+    pool_allocator& operator=(const pool_allocator&) = delete;
+
+    /**
+     * @brief Destructor.
+     * @note Complexity: O(c) in time, O(1) in space, where c is the number of
+     *       allocated chunks.
+     */
+    ~pool_allocator()
+    {
+        for (slot* chunk : chunks_)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    /**
+     * @brief Returns memory for a single node.
+     * @note Complexity: O(1) in time (amortized), O(1) in space.
+     */
+    Node* allocate()
+    {
+        if (free_list_ != nullptr)
+        {
+            slot* recycled = free_list_;
+            free_list_ = free_list_->next;
+            return reinterpret_cast<Node*>(recycled);
+        }
+
+        if (next_ == end_)
+        {
+            const size_t chunk_size =
+                chunks_.empty()
+                    ? min_chunk_size
+                    : std::min(2 * chunk_size_, size_t{max_chunk_size});
+
+            chunks_.push_back(
+                static_cast<slot*>(::operator new(chunk_size * sizeof(slot))));
+
+            chunk_size_ = chunk_size;
+            next_ = chunks_.back();
+            end_ = next_ + chunk_size;
+        }
+
+        return reinterpret_cast<Node*>(next_++);
+    }
+
+    /**
+     * @brief Returns the memory of a node to the pool.
+     * @note Complexity: O(1) in both time and space.
+     */
+    void deallocate(Node* p)
+    {
+        slot* freed = reinterpret_cast<slot*>(p);
+        freed->next = free_list_;
+        free_list_ = freed;
+    }
+
+private:
+    /** @brief Storage for a node, or a link of the free list. */
+    union slot
+    {
+        slot* next;
+        typename std::aligned_storage<sizeof(Node), alignof(Node)>::type node;
+    };
+
+    std::vector<slot*> chunks_;
+    size_t chunk_size_ = 0;
+
+    /* the unused part of the last chunk */
+    slot* next_ = nullptr;
+    slot* end_ = nullptr;
+
+    slot* free_list_ = nullptr;
+};
+
+/**
+ * @brief A singly-linked list.
+ * @note The Allocator policy determines how the list nodes are allocated.
+ */
+template<typename T, template<typename> class Allocator = heap_allocator>
 class list
 {
 private:
@@ -17,20 +142,40 @@ private:
     };
 
 public:
+    /**
+     * @brief Creates an empty list.
+     * @param skip_interval The distance between consecutive checkpoints of
+     *        the skip index (0 means the list has no skip index).
+     * @see set_skip_interval
+     */
+    explicit list(const size_t skip_interval = 0)
+        : skip_interval_(skip_interval)
+    {
+        /* nothing needs to be done here */
+    }
+
     /**
      * @brief Destructor.
      * @note Complexity: O(m) in time, O(1) in space, where m is the number
-     *       of nodes in the list.
+     *       of nodes in the list (if the allocator releases all nodes at once
+     *       and T is trivially destructible, the nodes are not visited).
      */
     ~list()
     {
+        /* the allocator releases the memory of all nodes at once */
+        if (Allocator<node>::releases_in_bulk &&
+            std::is_trivially_destructible<T>::value)
+        {
+            return;
+        }
+
         node* position = head_;
 
         while (position != nullptr)
         {
             node* node_to_delete = position;
             position = position->next_;
-            delete node_to_delete;
+            destroy_node(node_to_delete);
         }
     }
 
@@ -42,23 +187,99 @@ public:
     void insert(const T& value)
     {
         node* old_head = head_;
-        head_ = new node;
+        head_ = create_node();
         head_->value_ = value;
         head_->next_ = old_head;
 
+        /* the new node is at distance size_ from the last node */
+        if (skip_interval_ > 0 && size_ % skip_interval_ == 0)
+        {
+            checkpoints_.push_back(head_);
+        }
+
         ++size_;
     }
 
+    /**
+     * @brief Sets the distance k between consecutive checkpoints of the skip
+     *        index, which stores the nodes at distances 0, k, 2k, ... from the
+     *        last node (k = 0 removes the skip index).
+     * @note Nodes are only inserted at the head of the list, so the distance
+     *       of a node from the last node never changes, and insert() keeps
+     *       the skip index up to date in O(1) time.
+     * @note With a skip index, get_nth_to_last() runs in O(k) time, at a cost
+     *       of one pointer per k nodes of memory.
+     * @note Complexity: O(m) in time, O(m/k) in space, where m is the number
+     *       of nodes in the list.
+     */
+    void set_skip_interval(const size_t skip_interval)
+    {
+        skip_interval_ = skip_interval;
+        checkpoints_.clear();
+
+        if (skip_interval_ == 0)
+        {
+            checkpoints_.shrink_to_fit();
+            return;
+        }
+
+        checkpoints_.resize((size_ + skip_interval_ - 1) / skip_interval_);
+
+        size_t distance = size_;
+
+        for (node* position = head_; position != nullptr;
+             position = position->next_)
+        {
+            /* distance of position from the last node */
+            --distance;
+
+            if (distance % skip_interval_ == 0)
+            {
+                checkpoints_[distance / skip_interval_] = position;
+            }
+        }
+    }
+
+    /** @brief Returns the distance between checkpoints of the skip index. */
+    size_t skip_interval() const
+    {
+        return skip_interval_;
+    }
+
     /**
      * @brief Returns the n-th to last value in the list, with n = 0 meaning the
      *        last value in the list.
      * @note Complexity: O(m) in time, O(1) in space, where m is the number
-     *       of nodes in the list.
+     *       of nodes in the list, or O(k) in time if the list has a skip index
+     *       with checkpoints every k nodes.
      */
     const T& get_nth_to_last(const size_t n)
     {
         assert(n < size_);
 
+        if (skip_interval_ > 0)
+        {
+            /* first checkpoint at distance >= n from the last node */
+            size_t checkpoint = (n + skip_interval_ - 1) / skip_interval_;
+
+            node* position = head_;
+            size_t distance = size_ - 1;
+
+            /* if there is no such checkpoint, start from the head */
+            if (checkpoint < checkpoints_.size())
+            {
+                position = checkpoints_[checkpoint];
+                distance = checkpoint * skip_interval_;
+            }
+
+            for (; distance > n; --distance)
+            {
+                position = position->next_;
+            }
+
+            return position->value_;
+        }
+
         node* left = head_;
         node* right = head_;
 
@@ -88,8 +309,25 @@ public:
     }
 
 private:
+    node* create_node()
+    {
+        return new (allocator_.allocate()) node;
+    }
+
+    void destroy_node(node* p)
+    {
+        p->~node();
+        allocator_.deallocate(p);
+    }
+
     node* head_ = nullptr;
     size_t size_ = 0;
+
+    /* checkpoints_[i] is the node at distance i*skip_interval_ from the last */
+    size_t skip_interval_;
+    std::vector<node*> checkpoints_;
+
+    Allocator<node> allocator_;
 };
 
 #endif /* __LIST_HPP__ */
@@ -4,24 +4,122 @@
 
 #include <cassert>
 #include <iostream>
+#include <random>
 #include "list.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+#ifdef BENCHMARK
+
+/*
+ * Each iteration queries the n-th to last value of a list with m values for a
+ * random n; the list has a skip index with checkpoints every k nodes (k = 0
+ * means no skip index).
+ */
+
+template<size_t k>
+void bench_get_nth_to_last(benchmark::state& state)
+{
+    list<size_t, pool_allocator> L(k);
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        L.insert(i);
+    }
+
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<size_t> distribution(0, state.size() - 1);
+
+    std::vector<size_t> queries(1024);
+    for (size_t& n : queries)
+    {
+        n = distribution(generator);
+    }
+
+    size_t i = 0;
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(L.get_nth_to_last(queries[i++ % 1024]));
+    }
+
+    state.set_items_processed(1);
+}
+
+void bench_get_nth_to_last_no_index(benchmark::state& state)
+{
+    bench_get_nth_to_last<0>(state);
+}
+
+void bench_get_nth_to_last_skip_16(benchmark::state& state)
+{
+    bench_get_nth_to_last<16>(state);
+}
+
+void bench_get_nth_to_last_skip_256(benchmark::state& state)
+{
+    bench_get_nth_to_last<256>(state);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 22, 4);
+
+REGISTER_BENCHMARK(bench_get_nth_to_last_no_index, sizes);
+REGISTER_BENCHMARK(bench_get_nth_to_last_skip_16, sizes);
+REGISTER_BENCHMARK(bench_get_nth_to_last_skip_256, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
     {
         list<size_t> L;
+        list<size_t, pool_allocator> P;
+
+        /* lists with skip indices (including one built after the inserts) */
+        list<size_t> S1(1);
+        list<size_t> S3(3);
+        list<size_t, pool_allocator> S16(16);
+        list<size_t> S7;
 
         for (size_t i = 0; i < n; ++i)
         {
             L.insert(i);
+            P.insert(i);
+            S1.insert(i);
+            S3.insert(i);
+            S16.insert(i);
+            S7.insert(i);
         }
 
+        S7.set_skip_interval(7);
+
         assert(L.size() == n);
+        assert(P.size() == n);
 
         for (size_t i = 0; i < n; ++i)
         {
             assert(L.get_nth_to_last(i) == i);
+            assert(P.get_nth_to_last(i) == i);
+            assert(S1.get_nth_to_last(i) == i);
+            assert(S3.get_nth_to_last(i) == i);
+            assert(S16.get_nth_to_last(i) == i);
+            assert(S7.get_nth_to_last(i) == i);
+        }
+
+        /* the skip index must remain valid after further inserts */
+        S7.insert(n);
+        S16.set_skip_interval(0);
+        S16.insert(n);
+
+        for (size_t i = 0; i <= n; ++i)
+        {
+            assert(S7.get_nth_to_last(i) == i);
+            assert(S16.get_nth_to_last(i) == i);
         }
 
         std::cout << "passed tests for lists of size " << n << std::endl;
@@ -29,3 +127,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
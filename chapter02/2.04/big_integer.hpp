@@ -0,0 +1,527 @@
+#ifndef __BIG_INTEGER_HPP__
+#define __BIG_INTEGER_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief An arbitrary-precision non-negative integer stored as a contiguous
+ *        array of 64-bit limbs (least significant limb first).
+ * @note The limb array never has leading (most significant) zero limbs, so
+ *       zero is represented by an empty array.
+ */
+class big_integer
+{
+public:
+    using limb = uint64_t;
+
+    /* largest power of 10 which fits on a limb (used for base conversions) */
+    static constexpr limb decimal_base = 1000000000000000000ULL;
+    static constexpr int decimal_base_digits = 18;
+
+    /* operands shorter than this (in limbs) are multiplied in O(n²) */
+    static constexpr size_t karatsuba_threshold = 32;
+
+    big_integer() = default;
+
+    explicit big_integer(const limb n)
+    {
+        if (n > 0)
+        {
+            limbs_.push_back(n);
+        }
+    }
+
+    /**
+     * @brief Creates a number from its limbs (least significant limb first).
+     * @note Complexity: O(n) in both time and space, where n is the number of
+     *       limbs.
+     */
+    explicit big_integer(std::vector<limb> limbs) : limbs_(std::move(limbs))
+    {
+        trim();
+    }
+
+    /** @brief Returns the limbs of the number (least significant first). */
+    const std::vector<limb>& limbs() const
+    {
+        return limbs_;
+    }
+
+    bool is_zero() const
+    {
+        return limbs_.empty();
+    }
+
+    /**
+     * @brief Creates a number from its base-10^18 digits, i.e., from chunks
+     *        c[0], c[1], ... such that the number is Σ c[i]·10^(18i).
+     * @note The chunks can take any 64-bit value (not only values below
+     *       10^18), which allows converting unnormalized digit sequences.
+     * @note Complexity: O(n²) in time, O(n) in space, where n is the number of
+     *       chunks.
+     */
+    static big_integer from_decimal_chunks(const std::vector<limb>& chunks)
+    {
+        big_integer result;
+
+        for (size_t i = chunks.size(); i-- > 0;)
+        {
+            result.multiply_add(decimal_base, chunks[i]);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Returns the base-10^18 digits of the number (least significant
+     *        first, each on [0,10^18-1]); zero has no digits.
+     * @note Complexity: O(n²) in time, O(n) in space, where n is the number of
+     *       limbs.
+     */
+    std::vector<limb> to_decimal_chunks() const
+    {
+        std::vector<limb> chunks;
+        std::vector<limb> quotient = limbs_;
+
+        while (quotient.empty() == false)
+        {
+            chunks.push_back(divide(quotient, decimal_base));
+
+            while (quotient.empty() == false && quotient.back() == 0)
+            {
+                quotient.pop_back();
+            }
+        }
+
+        return chunks;
+    }
+
+    /**
+     * @brief Returns the decimal representation of the number.
+     * @note Complexity: O(n²) in time, O(n) in space, where n is the number of
+     *       limbs.
+     */
+    std::string to_string() const
+    {
+        std::vector<limb> chunks = to_decimal_chunks();
+
+        if (chunks.empty())
+        {
+            return "0";
+        }
+
+        std::string str = std::to_string(chunks.back());
+        char buffer[decimal_base_digits + 1];
+
+        /* all chunks except the most significant one are zero-padded */
+        for (size_t i = chunks.size() - 1; i-- > 0;)
+        {
+            std::snprintf(buffer,
+                          sizeof(buffer),
+                          "%018llu",
+                          static_cast<unsigned long long>(chunks[i]));
+            str += buffer;
+        }
+
+        return str;
+    }
+
+    /**
+     * @brief Adds another number to this one.
+     * @note Complexity: O(m+n) in time, O(1) in space (amortized), where m and
+     *       n are the number of limbs in both numbers.
+     */
+    big_integer& operator+=(const big_integer& other)
+    {
+        if (limbs_.size() < other.limbs_.size())
+        {
+            limbs_.resize(other.limbs_.size(), 0);
+        }
+
+        if (add(limbs_.data(),
+                limbs_.size(),
+                other.limbs_.data(),
+                other.limbs_.size()))
+        {
+            limbs_.push_back(1);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Subtracts another number (which must not be larger) from this one.
+     * @note Complexity: O(m+n) in time, O(1) in space, where m and n are the
+     *       number of limbs in both numbers.
+     */
+    big_integer& operator-=(const big_integer& other)
+    {
+        assert(other <= *this);
+
+        subtract(limbs_.data(),
+                 limbs_.size(),
+                 other.limbs_.data(),
+                 other.limbs_.size());
+        trim();
+
+        return *this;
+    }
+
+    /**
+     * @brief Returns the product of two numbers (Karatsuba multiplication).
+     * @note Complexity: O(m·n^0.585) in time, O(m+n) in space, where m >= n
+     *       are the number of limbs in both numbers.
+     */
+    friend big_integer operator*(const big_integer& a, const big_integer& b)
+    {
+        if (a.is_zero() || b.is_zero())
+        {
+            return big_integer();
+        }
+
+        const std::vector<limb>& x = a.limbs_;
+        const std::vector<limb>& y = b.limbs_;
+
+        std::vector<limb> product(x.size() + y.size());
+        std::vector<limb> scratch(
+            scratch_size(std::min(x.size(), y.size())));
+
+        multiply(x.data(),
+                 x.size(),
+                 y.data(),
+                 y.size(),
+                 product.data(),
+                 scratch.data());
+
+        return big_integer(std::move(product));
+    }
+
+    friend big_integer operator+(big_integer a, const big_integer& b)
+    {
+        return a += b;
+    }
+
+    friend big_integer operator-(big_integer a, const big_integer& b)
+    {
+        return a -= b;
+    }
+
+    friend bool operator==(const big_integer& a, const big_integer& b)
+    {
+        return a.limbs_ == b.limbs_;
+    }
+
+    friend bool operator!=(const big_integer& a, const big_integer& b)
+    {
+        return a.limbs_ != b.limbs_;
+    }
+
+    friend bool operator<(const big_integer& a, const big_integer& b)
+    {
+        if (a.limbs_.size() != b.limbs_.size())
+        {
+            return a.limbs_.size() < b.limbs_.size();
+        }
+
+        return std::lexicographical_compare(a.limbs_.rbegin(),
+                                            a.limbs_.rend(),
+                                            b.limbs_.rbegin(),
+                                            b.limbs_.rend());
+    }
+
+    friend bool operator<=(const big_integer& a, const big_integer& b)
+    {
+        return (b < a) == false;
+    }
+
+private:
+    /** @brief Computes a + b + carry and returns the carry out. */
+    static unsigned char add_carry(const unsigned char carry,
+                                   const limb a,
+                                   const limb b,
+                                   limb& sum)
+    {
+#if defined(__x86_64__)
+        unsigned long long result;
+        const unsigned char carry_out = _addcarry_u64(carry, a, b, &result);
+        sum = result;
+        return carry_out;
+#else
+        const limb partial = a + carry;
+        sum = partial + b;
+        return (partial < carry) | (sum < b);
+#endif
+    }
+
+    /** @brief Computes a - b - borrow and returns the borrow out. */
+    static unsigned char sub_borrow(const unsigned char borrow,
+                                    const limb a,
+                                    const limb b,
+                                    limb& difference)
+    {
+#if defined(__x86_64__)
+        unsigned long long result;
+        const unsigned char borrow_out = _subborrow_u64(borrow, a, b, &result);
+        difference = result;
+        return borrow_out;
+#else
+        const limb partial = a - borrow;
+        difference = partial - b;
+        return (a < static_cast<limb>(borrow)) | (partial < b);
+#endif
+    }
+
+    /**
+     * @brief Adds y (with ny limbs) to x (with nx >= ny limbs).
+     * @return The carry out of the most significant limb of x.
+     */
+    static unsigned char add(limb* x,
+                             const size_t nx,
+                             const limb* y,
+                             const size_t ny)
+    {
+        assert(nx >= ny);
+
+        unsigned char carry = 0;
+        size_t i = 0;
+
+        for (; i < ny; ++i)
+        {
+            carry = add_carry(carry, x[i], y[i], x[i]);
+        }
+        for (; carry && i < nx; ++i)
+        {
+            carry = add_carry(carry, x[i], 0, x[i]);
+        }
+
+        return carry;
+    }
+
+    /**
+     * @brief Subtracts y (with ny limbs) from x (with nx >= ny limbs).
+     * @return The borrow out of the most significant limb of x.
+     */
+    static unsigned char subtract(limb* x,
+                                  const size_t nx,
+                                  const limb* y,
+                                  const size_t ny)
+    {
+        assert(nx >= ny);
+
+        unsigned char borrow = 0;
+        size_t i = 0;
+
+        for (; i < ny; ++i)
+        {
+            borrow = sub_borrow(borrow, x[i], y[i], x[i]);
+        }
+        for (; borrow && i < nx; ++i)
+        {
+            borrow = sub_borrow(borrow, x[i], 0, x[i]);
+        }
+
+        return borrow;
+    }
+
+    /**
+     * @brief Computes z = x·y, where x has nx limbs, y has ny limbs and z has
+     *        room for nx+ny limbs (schoolbook multiplication).
+     * @note Complexity: O(nx·ny) in time, O(1) in space.
+     */
+    static void multiply_schoolbook(const limb* x,
+                                    const size_t nx,
+                                    const limb* y,
+                                    const size_t ny,
+                                    limb* z)
+    {
+        std::fill(z, z + nx + ny, 0);
+
+        for (size_t i = 0; i < ny; ++i)
+        {
+            limb carry = 0;
+
+            for (size_t j = 0; j < nx; ++j)
+            {
+                unsigned __int128 t =
+                    static_cast<unsigned __int128>(x[j]) * y[i] + z[i + j] +
+                    carry;
+                z[i + j] = static_cast<limb>(t);
+                carry = static_cast<limb>(t >> 64);
+            }
+
+            z[i + nx] = carry;
+        }
+    }
+
+    /** @brief Returns the scratch space needed by karatsuba() for n limbs. */
+    static size_t scratch_size(const size_t n)
+    {
+        if (n < karatsuba_threshold)
+        {
+            return 0;
+        }
+
+        const size_t k = n - n / 2 + 1;
+
+        return 4 * k + scratch_size(k);
+    }
+
+    /**
+     * @brief Computes z = x·y, where x and y have n limbs each and z has room
+     *        for 2n limbs, using scratch_size(n) limbs of scratch space.
+     * @note Writing x = x1·B^h + x0 and y = y1·B^h + y0, the product is
+     *       z2·B^(2h) + z1·B^h + z0 with z0 = x0·y0, z2 = x1·y1 and
+     *       z1 = (x0+x1)·(y0+y1) - z0 - z2, i.e., three half-size products.
+     * @note Complexity: O(n^1.585) in time, O(1) in space (besides scratch).
+     */
+    static void karatsuba(const limb* x,
+                          const limb* y,
+                          const size_t n,
+                          limb* z,
+                          limb* scratch)
+    {
+        if (n < karatsuba_threshold)
+        {
+            multiply_schoolbook(x, n, y, n, z);
+            return;
+        }
+
+        /* the low halves have h limbs, the high halves k >= h limbs */
+        const size_t h = n / 2;
+        const size_t k = n - h;
+
+        karatsuba(x, y, h, z, scratch);
+        karatsuba(x + h, y + h, k, z + 2 * h, scratch);
+
+        /* sums of the halves (k+1 limbs each) and their product */
+        limb* sx = scratch;
+        limb* sy = sx + (k + 1);
+        limb* z1 = sy + (k + 1);
+
+        std::copy(x + h, x + n, sx);
+        std::copy(y + h, y + n, sy);
+        sx[k] = add(sx, k, x, h);
+        sy[k] = add(sy, k, y, h);
+
+        karatsuba(sx, sy, k + 1, z1, z1 + 2 * (k + 1));
+
+        subtract(z1, 2 * (k + 1), z, 2 * h);
+        subtract(z1, 2 * (k + 1), z + 2 * h, 2 * k);
+
+        /* z1 < B^(2k+1), so only its 2k+1 lowest limbs can be nonzero */
+        add(z + h, 2 * n - h, z1, 2 * k + 1);
+    }
+
+    /**
+     * @brief Computes z = x·y, where x has nx limbs, y has ny limbs and z has
+     *        room for nx+ny limbs, using scratch_size(min(nx,ny)) limbs of
+     *        scratch space.
+     * @note If the operands have different lengths, the longer one is split
+     *       into pieces as long as the shorter one, and each piece is
+     *       multiplied by the shorter operand using Karatsuba multiplication.
+     */
+    static void multiply(const limb* x,
+                         size_t nx,
+                         const limb* y,
+                         size_t ny,
+                         limb* z,
+                         limb* scratch)
+    {
+        if (nx < ny)
+        {
+            std::swap(x, y);
+            std::swap(nx, ny);
+        }
+
+        if (ny < karatsuba_threshold)
+        {
+            multiply_schoolbook(x, nx, y, ny, z);
+            return;
+        }
+
+        if (nx == ny)
+        {
+            karatsuba(x, y, ny, z, scratch);
+            return;
+        }
+
+        std::fill(z, z + nx + ny, 0);
+
+        std::vector<limb> piece(2 * ny);
+
+        for (size_t i = 0; i < nx; i += ny)
+        {
+            const size_t n = std::min(ny, nx - i);
+
+            multiply(x + i, n, y, ny, piece.data(), scratch);
+            add(z + i, nx + ny - i, piece.data(), n + ny);
+        }
+    }
+
+    /**
+     * @brief Divides x by a single limb d (in place).
+     * @return The remainder of the division.
+     * @note Complexity: O(n) in time, O(1) in space, where n is the number of
+     *       limbs in x.
+     */
+    static limb divide(std::vector<limb>& x, const limb d)
+    {
+        limb remainder = 0;
+
+        for (size_t i = x.size(); i-- > 0;)
+        {
+            unsigned __int128 t =
+                (static_cast<unsigned __int128>(remainder) << 64) | x[i];
+            x[i] = static_cast<limb>(t / d);
+            remainder = static_cast<limb>(t % d);
+        }
+
+        return remainder;
+    }
+
+    /**
+     * @brief Computes *this = *this·m + a.
+     * @note Complexity: O(n) in time, O(1) in space (amortized), where n is
+     *       the number of limbs.
+     */
+    void multiply_add(const limb m, const limb a)
+    {
+        limb carry = a;
+
+        for (limb& l : limbs_)
+        {
+            unsigned __int128 t = static_cast<unsigned __int128>(l) * m + carry;
+            l = static_cast<limb>(t);
+            carry = static_cast<limb>(t >> 64);
+        }
+
+        if (carry > 0)
+        {
+            limbs_.push_back(carry);
+        }
+    }
+
+    /** @brief Removes the leading zero limbs. */
+    void trim()
+    {
+        while (limbs_.empty() == false && limbs_.back() == 0)
+        {
+            limbs_.pop_back();
+        }
+    }
+
+    std::vector<limb> limbs_;
+};
+
+#endif /* __BIG_INTEGER_HPP__ */
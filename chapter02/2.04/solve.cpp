@@ -8,10 +8,19 @@
  *       215 + 58 = 273 is represented as {5,1,2} + {8,5} = {3,7,2}.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <list>
 #include <random>
+#include <string>
+#include <vector>
+
+#include "big_integer.hpp"
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /* a decimal digit (value on range [0,9]) */
 using digit = uint8_t;
@@ -105,6 +114,220 @@ number to_list(uint64_t n)
     return a;
 }
 
+/**
+ * @brief Converts a number stored as a list to a big_integer.
+ * @note Complexity: O(n²) in time, O(n) in space, where n is the number of
+ *       digits in a (digits are grouped into base-10^18 chunks, so the
+ *       constant factor is small).
+ * @note The "digits" of a may be larger than 9 (e.g. 10, as produced by
+ *       add_numbers), in which case a represents Σ a[i]·10^i; the carries are
+ *       propagated while the digits are grouped, so each chunk stays below
+ *       10^18.
+ */
+big_integer to_big_integer(const number& a)
+{
+    std::vector<big_integer::limb> chunks;
+
+    big_integer::limb factor = 1;
+    big_integer::limb carry = 0;
+    int position = 0;
+
+    auto push_digit = [&](const big_integer::limb value) {
+        if (position == 0)
+        {
+            chunks.push_back(0);
+        }
+
+        chunks.back() += factor * (value % 10);
+        carry = value / 10;
+        factor *= 10;
+
+        if (++position == big_integer::decimal_base_digits)
+        {
+            factor = 1;
+            position = 0;
+        }
+    };
+
+    for (const digit& d : a)
+    {
+        push_digit(d + carry);
+    }
+
+    while (carry > 0)
+    {
+        push_digit(carry);
+    }
+
+    return big_integer::from_decimal_chunks(chunks);
+}
+
+/**
+ * @brief Converts a number stored as a big_integer to a list.
+ * @note Complexity: O(n²) in time, O(n) in space, where n is the number of
+ *       digits in a.
+ */
+number to_list(const big_integer& a)
+{
+    number digits;
+
+    std::vector<big_integer::limb> chunks = a.to_decimal_chunks();
+
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        big_integer::limb chunk = chunks[i];
+
+        /* only the most significant chunk is not zero-padded */
+        for (int j = 0; j < big_integer::decimal_base_digits; ++j)
+        {
+            if (i + 1 == chunks.size() && chunk == 0)
+            {
+                break;
+            }
+            digits.push_back(chunk % 10);
+            chunk /= 10;
+        }
+    }
+
+    return digits;
+}
+
+/**
+ * @brief Returns the product of two numbers stored as linked lists (a simple
+ *        reference implementation used for testing big_integer).
+ * @note Complexity: O(m·n) in time, O(m+n) in space, where m and n are the
+ *       number of digits in a and b respectively.
+ */
+number multiply_numbers(const number& a, const number& b)
+{
+    std::vector<uint64_t> product(a.size() + b.size(), 0);
+
+    size_t i = 0;
+    for (const digit& da : a)
+    {
+        size_t j = i;
+        for (const digit& db : b)
+        {
+            product[j++] += da * db;
+        }
+        ++i;
+    }
+
+    number digits;
+    uint64_t carry = 0;
+
+    for (const uint64_t value : product)
+    {
+        carry += value;
+        digits.push_back(carry % 10);
+        carry /= 10;
+    }
+
+    /* remove the leading zeros */
+    while (digits.empty() == false && digits.back() == 0)
+    {
+        digits.pop_back();
+    }
+
+    return digits;
+}
+
+/**
+ * @brief Generates a random number with n digits (stored as a list).
+ * @note Complexity: O(n) in both time and space.
+ */
+number random_number(const size_t n)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::uniform_int_distribution<int> distribution(0, 9);
+
+    number a;
+
+    while (a.size() < n)
+    {
+        a.push_back(distribution(generator));
+    }
+
+    /* the most significant digit must not be zero */
+    if (n > 0 && a.back() == 0)
+    {
+        a.back() = 1;
+    }
+
+    return a;
+}
+
+#ifdef BENCHMARK
+
+/* the sizes are numbers of decimal digits of each operand */
+
+void bench_add_numbers(benchmark::state& state)
+{
+    number a = random_number(state.size());
+    number b = random_number(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(add_numbers(a, b));
+    }
+
+    state.set_items_processed(state.size());
+}
+
+void bench_big_integer_add(benchmark::state& state)
+{
+    big_integer a = to_big_integer(random_number(state.size()));
+    big_integer b = to_big_integer(random_number(state.size()));
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(a + b);
+    }
+
+    state.set_items_processed(state.size());
+}
+
+void bench_big_integer_multiply(benchmark::state& state)
+{
+    big_integer a = to_big_integer(random_number(state.size()));
+    big_integer b = to_big_integer(random_number(state.size()));
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(a * b);
+    }
+
+    state.set_items_processed(state.size());
+}
+
+void bench_big_integer_to_string(benchmark::state& state)
+{
+    big_integer a = to_big_integer(random_number(state.size()));
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(a.to_string());
+    }
+
+    state.set_items_processed(state.size());
+}
+
+const std::vector<size_t> sizes = benchmark::range(1000, 1000000, 10);
+
+REGISTER_BENCHMARK(bench_add_numbers, sizes);
+REGISTER_BENCHMARK(bench_big_integer_add, sizes);
+REGISTER_BENCHMARK(bench_big_integer_multiply, sizes);
+
+/* conversions to decimal are quadratic, so they are run on shorter numbers */
+REGISTER_BENCHMARK(bench_big_integer_to_string,
+                   benchmark::range(1000, 100000, 10));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -128,10 +351,76 @@ int main()
             number sum = add_numbers(a, b);
 
             assert(to_integer(a) + to_integer(b) == to_integer(sum));
+
+            assert(to_big_integer(a) == big_integer(na));
+            assert(to_big_integer(sum) == big_integer(na + nb));
+            assert(to_list(big_integer(na)) == a);
+            assert(big_integer(na).to_string() == std::to_string(na));
         }
 
         std::cout << "passed random tests for numbers up to " << n << std::endl;
     }
 
+    for (size_t n = 1; n <= 4000; n = 3 * n + 1)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            number a = random_number(n);
+            number b = random_number(n / (i % 4 + 1));
+
+            big_integer A = to_big_integer(a);
+            big_integer B = to_big_integer(b);
+
+            assert(to_list(A) == a);
+            assert(to_list(B) == b);
+
+            /* the digits of a are stored in reverse order */
+            std::string str;
+            for (const digit& d : a)
+            {
+                str.push_back('0' + d);
+            }
+            std::reverse(str.begin(), str.end());
+            assert(A.to_string() == str);
+
+            /* add_numbers may produce "digits" equal to 10 */
+            number sum = add_numbers(a, b);
+            assert(to_big_integer(sum) == A + B);
+            assert(to_list(A + B) == to_list(to_big_integer(sum)));
+
+            /* "digits" up to 255 are carried into the next chunks */
+            assert(to_big_integer(number(n, 255)) ==
+                   to_big_integer(number(n, 1)) * big_integer(255));
+
+            assert((A + B) - B == A);
+            assert((A + B) - A == B);
+            assert((A < B) != (B <= A));
+            assert(b.size() == a.size() || B < A);
+
+            assert(to_list(A * B) == multiply_numbers(a, b));
+            assert(A * B == B * A);
+            assert((A + B) * A == A * A + B * A);
+        }
+
+        std::cout << "passed random tests for numbers with " << n << " digits"
+                  << std::endl;
+    }
+
+    /* (L^n-1)² + 2·(L^n-1) + 1 = L^(2n), where L = 2^64 (maximum carries) */
+    for (size_t n = 1; n <= 300; n += 13)
+    {
+        big_integer A(std::vector<big_integer::limb>(n, ~uint64_t{0}));
+
+        std::vector<big_integer::limb> power(2 * n + 1, 0);
+        power.back() = 1;
+
+        assert(A * A + A + A + big_integer(1) == big_integer(power));
+        assert(big_integer(power) - big_integer(1) - A * A == A + A);
+    }
+
+    std::cout << "passed carry propagation tests" << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
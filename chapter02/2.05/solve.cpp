@@ -7,9 +7,20 @@
  */
 
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <random>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include "cycle.hpp"
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /** @brief A node of a singly-linked list. */
 class list_node
@@ -141,6 +152,75 @@ const list_node* get_loop_start_2(const list_node* head)
     return nullptr;
 }
 
+/**
+ * @brief Detects the starting node of a loop on a circular list using Brent's
+ *        cycle detection algorithm (see find_cycle).
+ * @param head The head of the list.
+ * @return A pointer to the node where the loop begins if the list has a loop,
+ *         otherwise nullptr.
+ * @note Complexity: O(n) in time, O(1) in space, where n is the number of
+ *       nodes in the list.
+ * @note The successor of nullptr is nullptr itself, so a list without a loop
+ *       ends in a "cycle" which starts at nullptr.
+ */
+const list_node* get_loop_start_3(const list_node* head)
+{
+    auto next = [](const list_node* node) {
+        return node != nullptr ? node->next : nullptr;
+    };
+
+    return find_cycle(head, next).start;
+}
+
+/**
+ * @brief Finds the cycle reached from x0 on a functional graph by storing the
+ *        position of each visited node (a reference for find_cycle).
+ * @note Complexity: O(mu+lambda) in both time and space.
+ */
+cycle<uint32_t> find_cycle_with_map(const uint32_t x0,
+                                    const std::vector<uint32_t>& next)
+{
+    std::unordered_map<uint32_t, uint64_t> position;
+
+    uint32_t x = x0;
+
+    for (uint64_t i = 0; position.find(x) == position.end(); ++i)
+    {
+        position[x] = i;
+        x = next[x];
+    }
+
+    cycle<uint32_t> result;
+
+    result.start = x;
+    result.tail_length = position[x];
+    result.length = position.size() - position[x];
+
+    return result;
+}
+
+/**
+ * @brief Generates a random functional graph on the nodes [0,n) (i.e., the
+ *        successor of each node is a random node).
+ * @note Complexity: O(n) in both time and space.
+ */
+std::vector<uint32_t> random_successors(const size_t n)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::uniform_int_distribution<uint32_t> distribution(0, n - 1);
+
+    std::vector<uint32_t> next(n);
+
+    for (uint32_t& x : next)
+    {
+        x = distribution(generator);
+    }
+
+    return next;
+}
+
 /**
  * @brief Generates a random list which is circular with 50% probability.
  * @note Complexity: O(n) in both time and space.
@@ -181,6 +261,175 @@ list_node* random_list(const size_t n)
     return head;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The lists have n nodes, the last of which points back to the node in the
+ * middle of the list, so each solution has to walk through the whole list.
+ */
+
+template<typename Function>
+void bench_get_loop_start(benchmark::state& state, Function get_loop_start)
+{
+    std::vector<list_node*> nodes;
+
+    list_node* head = nullptr;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        list_node* old_head = head;
+        head = new list_node;
+        head->next = old_head;
+        nodes.push_back(head);
+    }
+
+    nodes.front()->next = nodes[state.size() / 2];
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(get_loop_start(head));
+    }
+
+    state.set_items_processed(state.size());
+
+    delete head;
+}
+
+void bench_get_loop_start_1(benchmark::state& state)
+{
+    bench_get_loop_start(state, get_loop_start_1);
+}
+
+void bench_get_loop_start_2(benchmark::state& state)
+{
+    bench_get_loop_start(state, get_loop_start_2);
+}
+
+void bench_get_loop_start_3(benchmark::state& state)
+{
+    bench_get_loop_start(state, get_loop_start_3);
+}
+
+/*
+ * The successor arrays have the same shape as the lists above (node i points
+ * to node i+1, and the last node points back to the node in the middle), and
+ * are written to a file which is then memory-mapped. The multi-start variant
+ * runs on a random functional graph, from 64 random starting nodes.
+ */
+
+const std::string successors_path = "successors.bin";
+
+/** @brief Writes the successors of the nodes [0,n) to a file. */
+template<typename Function>
+void write_successors(const size_t n, Function successor)
+{
+    std::ofstream file(successors_path, std::ios::binary);
+    std::vector<uint32_t> block;
+
+    for (size_t i = 0; i < n; i += block.size())
+    {
+        block.clear();
+
+        for (size_t j = i; j < n && block.size() < (1 << 20); ++j)
+        {
+            block.push_back(successor(j));
+        }
+
+        file.write(reinterpret_cast<const char*>(block.data()),
+                   block.size() * sizeof(uint32_t));
+    }
+}
+
+void bench_find_cycle_array(benchmark::state& state)
+{
+    const size_t n = state.size();
+
+    std::vector<uint32_t> next(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        next[i] = (i + 1 < n) ? i + 1 : n / 2;
+    }
+
+    auto successor = [&next](const uint32_t i) { return next[i]; };
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(find_cycle(uint32_t{0}, successor));
+    }
+
+    state.set_items_processed(n);
+}
+
+void bench_find_cycle_mapped(benchmark::state& state)
+{
+    const size_t n = state.size();
+
+    write_successors(n, [n](const size_t i) {
+        return (i + 1 < n) ? i + 1 : n / 2;
+    });
+
+    {
+        mapped_successors<uint32_t> successor(successors_path);
+
+        while (state.keep_running())
+        {
+            benchmark::do_not_optimize(find_cycle(uint32_t{0}, successor));
+        }
+    }
+
+    state.set_items_processed(n);
+
+    std::remove(successors_path.c_str());
+}
+
+void bench_find_cycles_mapped(benchmark::state& state)
+{
+    const size_t n = state.size();
+
+    std::mt19937 generator(n);
+    std::uniform_int_distribution<uint32_t> distribution(0, n - 1);
+
+    write_successors(n, [&](size_t) { return distribution(generator); });
+
+    std::vector<uint32_t> starts(64);
+    for (uint32_t& start : starts)
+    {
+        start = distribution(generator);
+    }
+
+    {
+        mapped_successors<uint32_t> successor(successors_path);
+
+        while (state.keep_running())
+        {
+            benchmark::do_not_optimize(find_cycles(starts, successor));
+        }
+    }
+
+    state.set_items_processed(starts.size());
+
+    std::remove(successors_path.c_str());
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 22, 4);
+
+REGISTER_BENCHMARK(bench_get_loop_start_1, sizes);
+REGISTER_BENCHMARK(bench_get_loop_start_2, sizes);
+REGISTER_BENCHMARK(bench_get_loop_start_3, sizes);
+
+/* the largest successor array has about 10^9 nodes (a 4 GB file) */
+const std::vector<size_t> array_sizes = benchmark::range(1 << 10, 1 << 30, 32);
+
+REGISTER_BENCHMARK(bench_find_cycle_array,
+                   benchmark::range(1 << 10, 1 << 25, 32));
+REGISTER_BENCHMARK(bench_find_cycle_mapped, array_sizes);
+REGISTER_BENCHMARK(bench_find_cycles_mapped, array_sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -189,6 +438,7 @@ int main()
         {
             list_node* head = random_list(n);
             assert(get_loop_start_1(head) == get_loop_start_2(head));
+            assert(get_loop_start_3(head) == get_loop_start_2(head));
 
             delete head;
         }
@@ -197,5 +447,55 @@ int main()
                   << std::endl;
     }
 
+    const std::string path = "successors.bin";
+
+    for (size_t n = 1; n <= 1000; n = 2 * n + 1)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            std::vector<uint32_t> next = random_successors(n);
+
+            std::ofstream(path, std::ios::binary)
+                .write(reinterpret_cast<const char*>(next.data()),
+                       next.size() * sizeof(uint32_t));
+
+            mapped_successors<uint32_t> mapped(path);
+            assert(mapped.size() == n);
+
+            auto successor = [&next](const uint32_t x) { return next[x]; };
+
+            std::vector<uint32_t> starts;
+            for (uint32_t x = 0; x < n; x += i % 7 + 1)
+            {
+                starts.push_back(x);
+            }
+
+            /* spawning threads is slow, so only some tests use them */
+            std::vector<cycle<uint32_t>> cycles =
+                find_cycles(starts, mapped, (i < 10) ? 4 : 1);
+
+            for (size_t j = 0; j < starts.size(); ++j)
+            {
+                cycle<uint32_t> expected = find_cycle_with_map(starts[j], next);
+                cycle<uint32_t> result = find_cycle(starts[j], successor);
+
+                assert(result.start == expected.start);
+                assert(result.length == expected.length);
+                assert(result.tail_length == expected.tail_length);
+
+                assert(cycles[j].start == expected.start);
+                assert(cycles[j].length == expected.length);
+                assert(cycles[j].tail_length == expected.tail_length);
+            }
+        }
+
+        std::cout << "passed random tests for functional graphs with " << n
+                  << " nodes" << std::endl;
+    }
+
+    std::remove(path.c_str());
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -0,0 +1,439 @@
+#ifndef __MULTI_STACK_HPP__
+#define __MULTI_STACK_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief An implementation of K stacks stored in a single array, with each
+ *        stack occupying a contiguous region of the array. The boundaries
+ *        between the regions move as the stacks grow, so a push only fails
+ *        to find room when the whole array is (mostly) full, in which case
+ *        the array grows geometrically.
+ * @note When a stack overflows its region, the free space is redistributed
+ *       among all stacks (Garwick's algorithm): 10% of it is split equally,
+ *       and 90% is split in proportion to how much each stack grew since the
+ *       previous redistribution, so the stacks which are growing get most of
+ *       the room. The array grows (to twice its capacity) whenever it is more
+ *       than 75% full, so a redistribution moving O(m) elements leaves at
+ *       least m/3 free slots, which makes pushes cost O(K) moves amortized
+ *       (i.e., O(1) for a fixed number of stacks K).
+ */
+template<typename T>
+class multi_stack
+{
+public:
+    /**
+     * @brief Constructor for K stacks sharing an array with a given initial
+     *        capacity (the array grows as needed).
+     */
+    explicit multi_stack(const size_t num_stacks, const size_t capacity = 0)
+        : num_stacks_(num_stacks),
+          base_(num_stacks + 1, 0),
+          size_(num_stacks, 0),
+          previous_size_(num_stacks, 0)
+    {
+        assert(num_stacks > 0);
+
+        if (capacity > 0)
+        {
+            values_ = allocate(capacity);
+            capacity_ = capacity;
+            distribute(size_, base_);
+        }
+    }
+
+    multi_stack(const multi_stack&) = delete;
+    multi_stack& operator=(const multi_stack&) = delete;
+
+    multi_stack(multi_stack&& other) noexcept
+        : num_stacks_(other.num_stacks_),
+          values_(other.values_),
+          capacity_(other.capacity_),
+          base_(std::move(other.base_)),
+          size_(std::move(other.size_)),
+          previous_size_(std::move(other.previous_size_))
+    {
+        other.values_ = nullptr;
+        other.capacity_ = 0;
+        other.base_.assign(num_stacks_ + 1, 0);
+        other.size_.assign(num_stacks_, 0);
+        other.previous_size_.assign(num_stacks_, 0);
+    }
+
+    multi_stack& operator=(multi_stack&& other) noexcept
+    {
+        std::swap(num_stacks_, other.num_stacks_);
+        std::swap(values_, other.values_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(base_, other.base_);
+        std::swap(size_, other.size_);
+        std::swap(previous_size_, other.previous_size_);
+
+        return *this;
+    }
+
+    /**
+     * @brief Destructor.
+     * @note Complexity: O(m) in time, O(1) in space, where m is the total
+     *       number of elements.
+     */
+    ~multi_stack()
+    {
+        for (size_t k = 0; k < num_stacks_; ++k)
+        {
+            destroy(values_ + base_[k], values_ + base_[k] + size_[k]);
+        }
+
+        ::operator delete(values_);
+    }
+
+    /**
+     * @brief Pushes a value onto the k-th stack.
+     * @note Complexity: O(1) in time (amortized for a fixed number of stacks),
+     *       O(1) in space (amortized).
+     */
+    void push(const size_t k, const T& value)
+    {
+        emplace(k, value);
+    }
+
+    void push(const size_t k, T&& value)
+    {
+        emplace(k, std::move(value));
+    }
+
+    /**
+     * @brief Constructs a value (from the given arguments) on top of the k-th
+     *        stack.
+     * @return A reference to the constructed value.
+     * @note Complexity: O(1) in time (amortized for a fixed number of stacks),
+     *       O(1) in space (amortized).
+     */
+    template<typename... Args>
+    T& emplace(const size_t k, Args&&... args)
+    {
+        T* slot = values_ + base_[k] + size_[k];
+
+        if (base_[k] + size_[k] < base_[k + 1])
+        {
+            new (slot) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            /* the arguments may refer to values which are about to move */
+            T value(std::forward<Args>(args)...);
+            reserve(k, 1);
+
+            slot = values_ + base_[k] + size_[k];
+            new (slot) T(std::move(value));
+        }
+
+        ++size_[k];
+
+        return *slot;
+    }
+
+    /**
+     * @brief Pushes the values [first, first + count) onto the k-th stack (in
+     *        this order, so the last value ends up on top); the values must not
+     *        be stored in this multi_stack.
+     * @note Complexity: O(count) in time (amortized for a fixed number of
+     *       stacks), O(count) in space (amortized).
+     */
+    void push_bulk(const size_t k, const T* first, const size_t count)
+    {
+        reserve(k, count);
+
+        std::uninitialized_copy(
+            first, first + count, values_ + base_[k] + size_[k]);
+        size_[k] += count;
+    }
+
+    /**
+     * @brief Pops a value from the k-th stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    void pop(const size_t k)
+    {
+        if (size_[k] == 0)
+        {
+            return;
+        }
+
+        --size_[k];
+        values_[base_[k] + size_[k]].~T();
+    }
+
+    /**
+     * @brief Pops the count values on top of the k-th stack (or all of its
+     *        values if it has fewer than count values).
+     * @note The values can be read through data(k) before they are popped.
+     * @note Complexity: O(count) in time, O(1) in space.
+     */
+    void pop_bulk(const size_t k, size_t count)
+    {
+        count = std::min(count, size_[k]);
+
+        size_[k] -= count;
+        destroy(values_ + base_[k] + size_[k],
+                values_ + base_[k] + size_[k] + count);
+    }
+
+    /**
+     * @brief Returns the value on top of the k-th stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    T& top(const size_t k)
+    {
+        assert(empty(k) == false);
+        return values_[base_[k] + size_[k] - 1];
+    }
+
+    const T& top(const size_t k) const
+    {
+        assert(empty(k) == false);
+        return values_[base_[k] + size_[k] - 1];
+    }
+
+    /**
+     * @brief Returns the values of the k-th stack (which are contiguous, from
+     *        the bottom to the top of the stack).
+     * @note The pointer is invalidated by any push onto any stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T* data(const size_t k) const
+    {
+        return values_ + base_[k];
+    }
+
+    /**
+     * @brief Returns the number of elements on the k-th stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t size(const size_t k) const
+    {
+        return size_[k];
+    }
+
+    /**
+     * @brief Returns true if the k-th stack is empty, false otherwise.
+     * @note Complexity: O(1) in both time and space.
+     */
+    bool empty(const size_t k) const
+    {
+        return size_[k] == 0;
+    }
+
+    /** @brief Returns the number of stacks. */
+    size_t num_stacks() const
+    {
+        return num_stacks_;
+    }
+
+    /** @brief Returns the number of elements the array can store. */
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    static T* allocate(const size_t capacity)
+    {
+        return static_cast<T*>(::operator new(capacity * sizeof(T)));
+    }
+
+    static void destroy(T* first, T* last)
+    {
+        for (; first != last; ++first)
+        {
+            first->~T();
+        }
+    }
+
+    /**
+     * @brief Moves the elements [first, last) to the uninitialized memory
+     *        starting at destination (which may overlap [first, last)).
+     */
+    static void relocate(T* first, T* last, T* destination)
+    {
+        if (destination < first)
+        {
+            for (; first != last; ++first, ++destination)
+            {
+                new (destination) T(std::move(*first));
+                first->~T();
+            }
+        }
+        else if (destination > first)
+        {
+            destination += last - first;
+
+            while (last != first)
+            {
+                new (--destination) T(std::move(*--last));
+                last->~T();
+            }
+        }
+    }
+
+    /**
+     * @brief Makes room for count more values on the k-th stack.
+     * @note Complexity: O(1) in time if the region of the k-th stack has room
+     *       for the values, otherwise O(m+count) in time, O(m+count) in space
+     *       (if the array grows), where m is the total number of elements.
+     */
+    void reserve(const size_t k, const size_t count)
+    {
+        if (base_[k] + size_[k] + count <= base_[k + 1])
+        {
+            return;
+        }
+
+        /* the sizes the stacks will have after the push */
+        std::vector<size_t> sizes = size_;
+        sizes[k] += count;
+
+        size_t total = 0;
+        for (size_t s : sizes)
+        {
+            total += s;
+        }
+
+        std::vector<size_t> base(num_stacks_ + 1);
+
+        /* grow the array if it would be more than 75% full */
+        if (4 * total > 3 * capacity_)
+        {
+            capacity_ = std::max(2 * capacity_, 2 * total);
+            T* values = allocate(capacity_);
+
+            distribute(sizes, base);
+
+            for (size_t j = 0; j < num_stacks_; ++j)
+            {
+                relocate(values_ + base_[j],
+                         values_ + base_[j] + size_[j],
+                         values + base[j]);
+            }
+
+            ::operator delete(values_);
+            values_ = values;
+        }
+        else
+        {
+            distribute(sizes, base);
+
+            /*
+             * move the stacks in place: first the stacks which move down (in
+             * increasing order), then those which move up (in decreasing
+             * order), so that no stack overwrites another
+             */
+            for (size_t j = 0; j < num_stacks_; ++j)
+            {
+                if (base[j] < base_[j])
+                {
+                    relocate(values_ + base_[j],
+                             values_ + base_[j] + size_[j],
+                             values_ + base[j]);
+                }
+            }
+            for (size_t j = num_stacks_; j-- > 0;)
+            {
+                if (base[j] > base_[j])
+                {
+                    relocate(values_ + base_[j],
+                             values_ + base_[j] + size_[j],
+                             values_ + base[j]);
+                }
+            }
+        }
+
+        base_ = base;
+        previous_size_ = sizes;
+    }
+
+    /**
+     * @brief Computes the region boundaries of the stacks given their sizes
+     *        (splitting the free space as described in the class comment).
+     */
+    void distribute(const std::vector<size_t>& sizes,
+                    std::vector<size_t>& base) const
+    {
+        size_t total = 0;
+        size_t total_growth = 0;
+
+        std::vector<size_t> growth(num_stacks_, 0);
+
+        for (size_t j = 0; j < num_stacks_; ++j)
+        {
+            total += sizes[j];
+
+            if (sizes[j] > previous_size_[j])
+            {
+                growth[j] = sizes[j] - previous_size_[j];
+                total_growth += growth[j];
+            }
+        }
+
+        assert(total <= capacity_);
+
+        const size_t free = capacity_ - total;
+
+        /* the part of the free space which is split equally */
+        const size_t equal = (total_growth > 0) ? free / 10 : free;
+        const size_t proportional = free - equal;
+
+        /* cumulative shares are rounded down, so no slot is lost */
+        size_t cumulative_growth = 0;
+        size_t shares = 0;
+
+        base[0] = 0;
+
+        for (size_t j = 0; j < num_stacks_; ++j)
+        {
+            cumulative_growth += growth[j];
+
+            size_t cumulative_shares = equal * (j + 1) / num_stacks_;
+
+            if (total_growth > 0)
+            {
+                cumulative_shares += static_cast<size_t>(
+                    static_cast<double>(proportional) * cumulative_growth /
+                    total_growth);
+            }
+
+            /* the last stack takes whatever is left */
+            if (j + 1 == num_stacks_)
+            {
+                cumulative_shares = free;
+            }
+
+            cumulative_shares = std::min(std::max(cumulative_shares, shares),
+                                         free);
+
+            base[j + 1] = base[j] + sizes[j] + (cumulative_shares - shares);
+            shares = cumulative_shares;
+        }
+    }
+
+    size_t num_stacks_;
+
+    /* uninitialized storage for capacity_ elements */
+    T* values_ = nullptr;
+    size_t capacity_ = 0;
+
+    /* the k-th stack occupies [base_[k], base_[k+1]) */
+    std::vector<size_t> base_;
+    std::vector<size_t> size_;
+
+    /* the stack sizes at the last redistribution of the free space */
+    std::vector<size_t> previous_size_;
+};
+
+#endif /* __MULTI_STACK_HPP__ */
@@ -2,9 +2,301 @@
  * TASK: Implement three stacks using a single array.
  */
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "multi_stack.hpp"
 #include "three_stacks.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+/**
+ * @brief Generates the indices of the stacks on which n values are pushed,
+ *        with the k-th stack receiving each value with probability weights[k]
+ *        (normalized).
+ * @note Complexity: O(n) in both time and space.
+ */
+std::vector<size_t> random_stacks(const size_t n,
+                                  const std::vector<double>& weights)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::discrete_distribution<size_t> distribution(weights.begin(),
+                                                    weights.end());
+
+    std::vector<size_t> stacks;
+
+    while (stacks.size() < n)
+    {
+        stacks.push_back(distribution(generator));
+    }
+
+    return stacks;
+}
+
+#ifdef BENCHMARK
+
+/*
+ * Each iteration pushes n values onto three stacks, with 90%, 9% and 1% of
+ * the values going to each stack, then pops all values. Since any stack may
+ * receive (almost) all values, three_stacks must be created with room for n
+ * values per stack. The "utilization" counter is the fraction of the array
+ * which is used when all n values are stored.
+ */
+
+const std::vector<double> skewed = {90, 9, 1};
+
+void bench_three_stacks_skewed(benchmark::state& state)
+{
+    const size_t n = state.size();
+    const std::vector<size_t> stacks = random_stacks(n, skewed);
+
+    while (state.keep_running())
+    {
+        three_stacks<int> S(n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            S.push(stacks[i], i);
+        }
+        for (size_t i = n; i-- > 0;)
+        {
+            S.pop(stacks[i]);
+        }
+
+        benchmark::do_not_optimize(S);
+    }
+
+    state.set_items_processed(2 * n);
+    state.set_counter("utilization", 1.0 / 3);
+}
+
+template<size_t num_stacks>
+void bench_multi_stack(benchmark::state& state,
+                       const std::vector<double>& weights)
+{
+    const size_t n = state.size();
+    const std::vector<size_t> stacks = random_stacks(n, weights);
+
+    size_t capacity = 0;
+
+    while (state.keep_running())
+    {
+        multi_stack<int> S(num_stacks);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            S.push(stacks[i], i);
+        }
+
+        capacity = S.capacity();
+
+        for (size_t i = n; i-- > 0;)
+        {
+            S.pop(stacks[i]);
+        }
+
+        benchmark::do_not_optimize(S);
+    }
+
+    state.set_items_processed(2 * n);
+    state.set_counter("utilization", static_cast<double>(n) / capacity);
+}
+
+void bench_multi_stack_skewed(benchmark::state& state)
+{
+    bench_multi_stack<3>(state, skewed);
+}
+
+void bench_multi_stack_uniform(benchmark::state& state)
+{
+    bench_multi_stack<3>(state, {1, 1, 1});
+}
+
+/* 16 stacks, the k-th of which receives a share proportional to 1/(k+1) */
+void bench_multi_stack_zipf_16(benchmark::state& state)
+{
+    std::vector<double> weights;
+    for (size_t k = 0; k < 16; ++k)
+    {
+        weights.push_back(1.0 / (k + 1));
+    }
+
+    bench_multi_stack<16>(state, weights);
+}
+
+/* the values are pushed and popped in spans of 64 values */
+void bench_multi_stack_skewed_bulk(benchmark::state& state)
+{
+    const size_t n = state.size() / 64;
+    const std::vector<size_t> stacks = random_stacks(n, skewed);
+    const std::vector<int> span(64, 1);
+
+    size_t capacity = 0;
+
+    while (state.keep_running())
+    {
+        multi_stack<int> S(3);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            S.push_bulk(stacks[i], span.data(), span.size());
+        }
+
+        capacity = S.capacity();
+
+        for (size_t i = n; i-- > 0;)
+        {
+            S.pop_bulk(stacks[i], span.size());
+        }
+
+        benchmark::do_not_optimize(S);
+    }
+
+    state.set_items_processed(2 * 64 * n);
+    state.set_counter("utilization", 64.0 * n / capacity);
+}
+
+const std::vector<size_t> sizes = benchmark::range(1 << 8, 1 << 24, 4);
+
+REGISTER_BENCHMARK(bench_three_stacks_skewed, sizes);
+REGISTER_BENCHMARK(bench_multi_stack_skewed, sizes);
+REGISTER_BENCHMARK(bench_multi_stack_uniform, sizes);
+REGISTER_BENCHMARK(bench_multi_stack_zipf_16, sizes);
+REGISTER_BENCHMARK(bench_multi_stack_skewed_bulk, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
+/**
+ * @brief Checks that all stacks of a multi_stack hold the same values as a
+ *        set of reference stacks.
+ */
+template<typename T>
+void check_stacks(const multi_stack<T>& S,
+                  const std::vector<std::vector<T>>& stacks)
+{
+    assert(S.num_stacks() == stacks.size());
+
+    size_t total = 0;
+
+    for (size_t k = 0; k < stacks.size(); ++k)
+    {
+        assert(S.size(k) == stacks[k].size());
+        assert(S.empty(k) == stacks[k].empty());
+        assert(std::equal(stacks[k].begin(), stacks[k].end(), S.data(k)));
+
+        total += stacks[k].size();
+    }
+
+    assert(total <= S.capacity());
+}
+
+/**
+ * @brief Runs random operations on K stacks of strings (whose moves are not
+ *        trivial) and compares the results with a set of std::vector stacks.
+ */
+void random_multi_stack_test(const size_t num_stacks, const size_t num_ops)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::uniform_int_distribution<int> operation(0, 9);
+    std::uniform_int_distribution<size_t> count(0, 20);
+
+    /* most values go to the first stack */
+    std::vector<double> weights(num_stacks, 1);
+    weights[0] = 4 * num_stacks;
+
+    std::vector<size_t> stacks = random_stacks(num_ops, weights);
+
+    multi_stack<std::string> S(num_stacks, num_ops % 3);
+    std::vector<std::vector<std::string>> R(num_stacks);
+
+    for (size_t i = 0; i < num_ops; ++i)
+    {
+        const size_t k = stacks[i];
+        const std::string value = std::to_string(i);
+
+        switch (operation(generator))
+        {
+            case 0:
+            {
+                S.pop(k);
+                if (R[k].empty() == false)
+                {
+                    R[k].pop_back();
+                }
+                break;
+            }
+            case 1:
+            {
+                std::vector<std::string> values(count(generator), value);
+                S.push_bulk(k, values.data(), values.size());
+                R[k].insert(R[k].end(), values.begin(), values.end());
+                break;
+            }
+            case 2:
+            {
+                const size_t n = count(generator);
+                S.pop_bulk(k, n);
+                R[k].resize(R[k].size() - std::min(n, R[k].size()));
+                break;
+            }
+            case 3:
+            {
+                /* push a value stored on another stack */
+                const size_t j = (k + 1) % num_stacks;
+                if (R[j].empty() == false)
+                {
+                    S.push(k, S.top(j));
+                    R[k].push_back(R[j].back());
+                }
+                break;
+            }
+            case 4:
+            {
+                assert(S.emplace(k, 3, 'x') == "xxx");
+                R[k].emplace_back(3, 'x');
+                break;
+            }
+            default:
+            {
+                std::string copy = value;
+                S.push(k, std::move(copy));
+                R[k].push_back(value);
+                break;
+            }
+        }
+
+        if (R[k].empty() == false)
+        {
+            assert(S.top(k) == R[k].back());
+        }
+    }
+
+    check_stacks(S, R);
+
+    /* moving the stacks must leave the source empty */
+    multi_stack<std::string> M(std::move(S));
+    check_stacks(M, R);
+
+    for (size_t k = 0; k < num_stacks; ++k)
+    {
+        assert(S.empty(k) == true);
+    }
+
+    S = std::move(M);
+    check_stacks(S, R);
+}
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -58,5 +350,47 @@ int main()
         std::cout << "passed tests for stacks of size " << n << std::endl;
     }
 
+    for (size_t num_ops = 0; num_ops <= 1000; num_ops += 50)
+    {
+        for (size_t num_stacks = 1; num_stacks <= 8; ++num_stacks)
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                random_multi_stack_test(num_stacks, num_ops);
+            }
+        }
+
+        std::cout << "passed random multi-stack tests with " << num_ops
+                  << " operations" << std::endl;
+    }
+
+    /*
+     * the array grows to max(2c, 2t) when t values would fill more than 3/4
+     * of its capacity c, so right after growing, it is at most 8/3 times as
+     * large as the number of values; it never shrinks, so its capacity is at
+     * most max(initial capacity, 8m/3), where m is the largest number of
+     * values it held
+     */
+    for (size_t n = 1; n <= 100000; n *= 10)
+    {
+        for (const size_t initial : {0, 100})
+        {
+            multi_stack<size_t> S(3, initial);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                S.push(i % 10 == 0 ? 1 : 0, i);
+
+                assert(3 * S.capacity() <= std::max(3 * initial, 8 * (i + 1)));
+            }
+
+            assert(S.size(0) + S.size(1) == n);
+        }
+    }
+
+    std::cout << "passed multi-stack utilization tests" << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
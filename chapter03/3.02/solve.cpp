@@ -4,11 +4,144 @@
  *       in O(1) complexity in both time and space.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <queue>
 #include <random>
+#include <string>
+#include <vector>
 #include "stack_min.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+#ifdef BENCHMARK
+
+/*
+ * Each iteration pushes n random values onto an empty stack, then pops them
+ * all, reading the stack minimum after every operation. The bytes/element
+ * counter is the memory held by the stack when it has all n values (for
+ * stack_min, the size of the nodes, without the allocator's overhead).
+ */
+
+template<typename Stack>
+void bench_stack_min(benchmark::state& state, double bytes_per_element)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<int> distribution;
+
+    std::vector<int> values(state.size());
+    for (int& value : values)
+    {
+        value = distribution(generator);
+    }
+
+    while (state.keep_running())
+    {
+        Stack S;
+
+        for (const int value : values)
+        {
+            S.push(value);
+            benchmark::do_not_optimize(S.min());
+        }
+        while (S.empty() == false)
+        {
+            benchmark::do_not_optimize(S.min());
+            S.pop();
+        }
+    }
+
+    state.set_items_processed(2 * values.size());
+    state.set_counter("bytes_per_element", bytes_per_element);
+}
+
+void bench_stack_min_nodes(benchmark::state& state)
+{
+    /* a node holds a value and two pointers */
+    struct node
+    {
+        int value;
+        void* next_node;
+        void* next_min;
+    };
+
+    bench_stack_min<stack_min<int>>(state, sizeof(node));
+}
+
+void bench_vector_stack_min(benchmark::state& state)
+{
+    vector_stack_min<int> S;
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<int> distribution;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        S.push(distribution(generator));
+    }
+
+    bench_stack_min<vector_stack_min<int>>(
+        state, static_cast<double>(S.bytes_used()) / state.size());
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 24, 4);
+
+REGISTER_BENCHMARK(bench_stack_min_nodes, sizes);
+REGISTER_BENCHMARK(bench_vector_stack_min, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
+/** @brief Monoid which concatenates strings (it is not commutative). */
+struct concatenation_monoid
+{
+    static std::string combine(const std::string& a, const std::string& b)
+    {
+        return a + b;
+    }
+};
+
+/**
+ * @brief Runs random pushes and pops on a stack with an aggregate, comparing
+ *        the aggregate with the one computed from a copy of the stack values.
+ */
+template<typename Monoid, typename Aggregate>
+void random_aggregate_test(const int n, Aggregate reference)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::uniform_int_distribution<int> distribution(-n, n);
+    std::bernoulli_distribution push(0.6);
+
+    aggregate_stack<long, Monoid> S;
+    std::vector<long> values;
+
+    for (int i = 0; i < 4 * n; ++i)
+    {
+        if (push(generator) || values.empty())
+        {
+            values.push_back(distribution(generator));
+            S.push(values.back());
+        }
+        else
+        {
+            values.pop_back();
+            S.pop();
+        }
+
+        assert(S.size() == values.size());
+
+        if (values.empty() == false)
+        {
+            assert(S.top() == values.back());
+            assert(S.aggregate() == reference(values));
+        }
+    }
+}
+
 int main()
 {
     std::random_device device;
@@ -21,6 +154,7 @@ int main()
         for (int i = 0; i < 1000; ++i)
         {
             stack_min<int> S;
+            vector_stack_min<int> V;
 
             /* min-heap containing the minima of S */
             std::priority_queue<int, std::vector<int>, std::greater<int> > Q;
@@ -31,6 +165,7 @@ int main()
                 int value = distribution(generator);
 
                 S.push(value);
+                V.push(value);
 
                 if (Q.empty() == true || value <= Q.top())
                 {
@@ -38,12 +173,15 @@ int main()
                 }
 
                 assert(S.min() == Q.top());
+                assert(V.min() == Q.top());
             }
 
             /* pop all elements of the stack (one by one) */
             while (S.empty() == false)
             {
                 assert(S.min() == Q.top());
+                assert(V.min() == Q.top());
+                assert(V.top() == S.top());
 
                 /* if we are removing the stack minimum node */
                 if (S.top() == Q.top())
@@ -52,12 +190,64 @@ int main()
                 }
 
                 S.pop();
+                V.pop();
             }
+
+            assert(V.empty() == true);
+        }
+
+        for (int i = 0; i < 100; ++i)
+        {
+            random_aggregate_test<min_monoid<long>>(
+                n, [](const std::vector<long>& values) {
+                    return *std::min_element(values.begin(), values.end());
+                });
+            random_aggregate_test<max_monoid<long>>(
+                n, [](const std::vector<long>& values) {
+                    return *std::max_element(values.begin(), values.end());
+                });
+            random_aggregate_test<sum_monoid<long>>(
+                n, [](const std::vector<long>& values) {
+                    long sum = 0;
+                    for (const long value : values)
+                    {
+                        sum += value;
+                    }
+                    return sum;
+                });
         }
 
         std::cout << "passed random tests for stacks of size " << n
                   << std::endl;
     }
 
+    /* values which are moved or constructed in place */
+    aggregate_stack<std::string, max_monoid<std::string>> S;
+
+    std::string value = "b";
+    S.push(std::move(value));
+    S.emplace(3, 'a');
+    S.push(std::string("c"));
+
+    assert(S.top() == "c" && S.aggregate() == "c");
+    S.pop();
+    assert(S.top() == "aaa" && S.aggregate() == "b");
+    S.pop();
+    assert(S.top() == "b" && S.aggregate() == "b");
+
+    /* a custom monoid with only combine (the same one 3.05 uses) */
+    aggregate_stack<std::string, concatenation_monoid> C;
+
+    C.push("a");
+    C.push("b");
+    C.push("c");
+    assert(C.aggregate() == "abc");
+    C.pop();
+    assert(C.aggregate() == "ab");
+
+    std::cout << "passed tests for stacks of strings" << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
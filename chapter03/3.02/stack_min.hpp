@@ -1,7 +1,12 @@
 #ifndef __STACK_MIN_HPP__
 #define __STACK_MIN_HPP__
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 template<typename T>
 class stack_min
@@ -106,4 +111,251 @@ private:
     node* min_ = nullptr;
 };
 
+/*
+ * A monoid is a type with a static function combine(a, b) which is
+ * associative (but not necessarily commutative); for a stack holding the
+ * values v1, v2, ..., vn (from bottom to top), the aggregate of the stack is
+ * combine(...combine(combine(v1, v2), v3)..., vn). The monoids below have the
+ * same interface as those of aggregate_queue (3.05), so a monoid written for
+ * one container also works with the other.
+ *
+ * A monoid may also declare itself "selective" with a static constexpr bool
+ * member selective = true: its combine(a, b) then always returns a reference
+ * to one of its two arguments (as std::min and std::max do), so the stack can
+ * track which value is the aggregate instead of storing aggregates. Monoids
+ * without this member are not selective.
+ */
+
+/** @brief Monoid which aggregates values into their minimum. */
+template<typename T>
+struct min_monoid
+{
+    static constexpr bool selective = true;
+
+    static const T& combine(const T& a, const T& b)
+    {
+        return std::min(a, b);
+    }
+};
+
+/** @brief Monoid which aggregates values into their maximum. */
+template<typename T>
+struct max_monoid
+{
+    static constexpr bool selective = true;
+
+    static const T& combine(const T& a, const T& b)
+    {
+        return std::max(a, b);
+    }
+};
+
+/** @brief Monoid which aggregates values into their sum. */
+template<typename T>
+struct sum_monoid
+{
+    static T combine(const T& a, const T& b)
+    {
+        return a + b;
+    }
+};
+
+/**
+ * @brief Holds true if Monoid declares selective = true, false otherwise
+ *        (including when Monoid has no selective member).
+ */
+template<typename Monoid, typename = void>
+struct is_selective_monoid : std::false_type
+{
+};
+
+template<typename Monoid>
+struct is_selective_monoid<
+    Monoid,
+    typename std::enable_if<Monoid::selective>::type> : std::true_type
+{
+};
+
+/**
+ * @brief A stack stored in a contiguous array which can return the aggregate
+ *        of all its values (e.g. their minimum) under a monoid.
+ * @note For selective monoids (such as min_monoid and max_monoid), the stack
+ *       keeps a second stack with the indices of the values which were the
+ *       aggregate when they were pushed, so it only grows when a new aggregate
+ *       arrives. For other monoids, the aggregate of every prefix of the stack
+ *       is stored.
+ */
+template<typename T, typename Monoid = min_monoid<T>>
+class aggregate_stack
+{
+    typedef is_selective_monoid<Monoid> selective;
+
+    static_assert(selective::value == false ||
+                      std::is_same<decltype(Monoid::combine(
+                                       std::declval<const T&>(),
+                                       std::declval<const T&>())),
+                                   const T&>::value,
+                  "combine() of a selective monoid must return a reference "
+                  "to one of its arguments");
+
+public:
+    /**
+     * @brief Pushes a value onto the stack.
+     * @note Complexity: O(1) in time (amortized), O(1) in space (amortized).
+     */
+    void push(const T& value)
+    {
+        emplace(value);
+    }
+
+    void push(T&& value)
+    {
+        emplace(std::move(value));
+    }
+
+    /**
+     * @brief Constructs a value (from the given arguments) on top of the
+     *        stack.
+     * @note Complexity: O(1) in time (amortized), O(1) in space (amortized).
+     */
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        values_.emplace_back(std::forward<Args>(args)...);
+        update_after_push(selective());
+    }
+
+    /**
+     * @brief Returns the value on the top of the stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T& top() const
+    {
+        assert(empty() == false);
+        return values_.back();
+    }
+
+    /**
+     * @brief Pops the value on the top of the stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    void pop()
+    {
+        if (empty())
+        {
+            return;
+        }
+
+        update_before_pop(selective());
+        values_.pop_back();
+    }
+
+    /**
+     * @brief Returns the aggregate of all values on the stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T& aggregate() const
+    {
+        assert(empty() == false);
+        return aggregate(selective());
+    }
+
+    /**
+     * @brief Returns true if the stack is empty, false otherwise.
+     * @note Complexity: O(1) in both time and space.
+     */
+    bool empty() const
+    {
+        return values_.empty();
+    }
+
+    /** @brief Returns the number of values on the stack. */
+    size_t size() const
+    {
+        return values_.size();
+    }
+
+    /** @brief Returns the number of bytes allocated by the stack. */
+    size_t bytes_used() const
+    {
+        return values_.capacity() * sizeof(T) +
+               indices_.capacity() * sizeof(size_t) +
+               aggregates_.capacity() * sizeof(T);
+    }
+
+private:
+    void update_after_push(std::true_type)
+    {
+        /* the pushed value is selected if combine returns it (not ties) */
+        if (indices_.empty() ||
+            &Monoid::combine(values_[indices_.back()], values_.back()) ==
+                &values_.back())
+        {
+            indices_.push_back(values_.size() - 1);
+        }
+    }
+
+    void update_after_push(std::false_type)
+    {
+        if (aggregates_.empty())
+        {
+            aggregates_.push_back(values_.back());
+        }
+        else
+        {
+            aggregates_.push_back(
+                Monoid::combine(aggregates_.back(), values_.back()));
+        }
+    }
+
+    void update_before_pop(std::true_type)
+    {
+        if (indices_.back() == values_.size() - 1)
+        {
+            indices_.pop_back();
+        }
+    }
+
+    void update_before_pop(std::false_type)
+    {
+        aggregates_.pop_back();
+    }
+
+    const T& aggregate(std::true_type) const
+    {
+        return values_[indices_.back()];
+    }
+
+    const T& aggregate(std::false_type) const
+    {
+        return aggregates_.back();
+    }
+
+    std::vector<T> values_;
+
+    /* indices of the values which were the aggregate when pushed (selective) */
+    std::vector<size_t> indices_;
+
+    /* aggregates_[i] is the aggregate of values_[0..i] (not selective) */
+    std::vector<T> aggregates_;
+};
+
+/**
+ * @brief A stack stored in a contiguous array which can return its minimum
+ *        value (same interface as stack_min, without an allocation per push).
+ */
+template<typename T>
+class vector_stack_min : public aggregate_stack<T, min_monoid<T>>
+{
+public:
+    /**
+     * @brief Returns the minimum value on the stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T& min() const
+    {
+        return this->aggregate();
+    }
+};
+
 #endif /* __STACK_MIN_HPP__ */
@@ -9,9 +9,18 @@
  *       remain full).
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <random>
+#include <string>
+#include <vector>
 #include "stacks.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Returns the number of stacks necessary to store n elements if each
  *        stack can store at most capacity elements.
@@ -21,6 +30,194 @@ size_t needed_stacks(const size_t capacity, const size_t n)
     return (n / capacity) + (n % capacity > 0);
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The stacks hold n values (on stacks of capacity 64), and each iteration pops
+ * a value from a random stack and pushes a new one. Besides the throughput,
+ * the latencies of individual pop_at calls are measured (as counters), since
+ * lazy_stacks occasionally takes O(n) time to compact the stacks.
+ */
+
+template<typename Stacks>
+void bench_pop_at(benchmark::state& state)
+{
+    Stacks S(64);
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        S.push(i);
+    }
+
+    std::mt19937 generator(state.size());
+
+    auto random_stack = [&]() {
+        return std::uniform_int_distribution<size_t>(0, S.num_stacks() - 1)(
+            generator);
+    };
+
+    while (state.keep_running())
+    {
+        S.pop_at(random_stack());
+        S.push(0);
+    }
+
+    state.set_items_processed(1);
+
+    std::vector<double> latencies;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const size_t k = random_stack();
+
+        auto start = std::chrono::steady_clock::now();
+        S.pop_at(k);
+        auto end = std::chrono::steady_clock::now();
+
+        latencies.push_back(
+            std::chrono::duration<double, std::nano>(end - start).count());
+
+        S.push(0);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    state.set_counter("pop_at_p50_ns", benchmark::percentile(latencies, 0.5));
+    state.set_counter("pop_at_p99_ns", benchmark::percentile(latencies, 0.99));
+    state.set_counter("pop_at_max_ns", latencies.back());
+}
+
+void bench_pop_at_eager(benchmark::state& state)
+{
+    bench_pop_at<stacks<int>>(state);
+}
+
+void bench_pop_at_lazy(benchmark::state& state)
+{
+    bench_pop_at<lazy_stacks<int>>(state);
+}
+
+REGISTER_BENCHMARK(bench_pop_at_eager, benchmark::range(256, 1 << 16, 4));
+REGISTER_BENCHMARK(bench_pop_at_lazy, benchmark::range(256, 1 << 22, 4));
+
+BENCHMARK_MAIN()
+
+#else
+
+/**
+ * @brief Runs random operations on a lazy_stacks object, comparing it with a
+ *        set of std::vector stacks which follows the same rules.
+ */
+void random_lazy_test(const size_t capacity,
+                      const size_t num_ops,
+                      const bool auto_compact)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::uniform_int_distribution<int> operation(0, 9);
+
+    lazy_stacks<std::string> S(capacity, auto_compact);
+    std::vector<std::vector<std::string>> R;
+
+    /* flattens the reference stacks back into full stacks */
+    auto compact = [&]() {
+        std::vector<std::string> values;
+        for (const std::vector<std::string>& stack : R)
+        {
+            values.insert(values.end(), stack.begin(), stack.end());
+        }
+
+        R.clear();
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (i % capacity == 0)
+            {
+                R.emplace_back();
+            }
+            R.back().push_back(values[i]);
+        }
+    };
+
+    auto pop = [&]() {
+        R.back().pop_back();
+        while (R.empty() == false && R.back().empty())
+        {
+            R.pop_back();
+        }
+    };
+
+    for (size_t i = 0; i < num_ops; ++i)
+    {
+        const int op = operation(generator);
+
+        if (op < 5 || R.empty())
+        {
+            if (R.empty() || R.back().size() == capacity)
+            {
+                R.emplace_back();
+            }
+            R.back().push_back(std::to_string(i));
+            S.push(R.back().back());
+        }
+        else if (op == 5)
+        {
+            pop();
+            S.pop();
+        }
+        else if (op == 6)
+        {
+            compact();
+            S.compact();
+        }
+        else
+        {
+            const size_t k = std::uniform_int_distribution<size_t>(
+                0, R.size() - 1)(generator);
+
+            if (k + 1 == R.size())
+            {
+                pop();
+            }
+            else if (R[k].empty() == false)
+            {
+                R[k].pop_back();
+
+                size_t size = 0;
+                size_t holes = 0;
+                for (size_t j = 0; j < R.size(); ++j)
+                {
+                    size += R[j].size();
+                    holes += (j + 1 < R.size()) ? capacity - R[j].size() : 0;
+                }
+
+                if (auto_compact && holes > size)
+                {
+                    compact();
+                }
+            }
+
+            S.pop_at(k);
+        }
+
+        assert(S.num_stacks() == R.size());
+
+        size_t size = 0;
+        for (size_t k = 0; k < R.size(); ++k)
+        {
+            assert(S.stack_size(k) == R[k].size());
+            size += R[k].size();
+        }
+
+        assert(S.size() == size);
+
+        if (R.empty() == false)
+        {
+            assert(S.top() == R.back().back());
+        }
+    }
+}
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -30,15 +227,20 @@ int main()
             stacks<int> S(capacity);
             std::vector<int> V;
 
+            /* compacting after every pop_at makes it equivalent to S */
+            lazy_stacks<int> L(capacity);
+
             /* add elements to the stacks */
             for (size_t i = 0; i < n; ++i)
             {
                 assert(S.size() == i);
 
                 S.push(i);
+                L.push(i);
                 V.push_back(i);
 
                 assert(S.top() == V.back());
+                assert(L.top() == V.back());
             }
 
             /* pop all elements from the stacks */
@@ -49,6 +251,10 @@ int main()
 
                 assert(S.num_stacks() == needed_stacks(capacity, n - i));
 
+                assert(L.size() == S.size());
+                assert(L.top() == S.top());
+                assert(L.num_stacks() == S.num_stacks());
+
                 /* stack from which an element will be popped */
                 size_t k = S.size() % S.num_stacks();
 
@@ -63,6 +269,8 @@ int main()
                 }
 
                 S.pop_at(k);
+                L.pop_at(k);
+                L.compact();
             }
 
             /* the stacks should be empty */
@@ -70,7 +278,13 @@ int main()
             assert(S.empty() == true);
             assert(S.num_stacks() == 0);
 
+            assert(L.empty() == true);
+            assert(L.num_stacks() == 0);
+
             assert(V.empty() == true);
+
+            random_lazy_test(capacity, n, n % 2 == 0);
+            random_lazy_test(capacity, 10 * n, n % 2 == 1);
         }
 
         std::cout << "passed tests for stacks of total size " << n << std::endl;
@@ -78,3 +292,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -3,7 +3,9 @@
 
 #include <cassert>
 #include <cstddef>
+#include <new>
 #include <stack>
+#include <utility>
 #include <vector>
 
 template<typename T>
@@ -169,4 +171,335 @@ private:
     size_t capacity_;
 };
 
+/**
+ * @brief A pool of fixed-size blocks of (uninitialized) storage for values of
+ *        type T; released blocks are kept and handed out again.
+ */
+template<typename T>
+class block_pool
+{
+public:
+    explicit block_pool(const size_t block_size) : block_size_(block_size)
+    {
+        /* nothing needs to be done here */
+    }
+
+    block_pool(const block_pool&) = delete;
+    block_pool& operator=(const block_pool&) = delete;
+
+    /**
+     * @brief Destructor.
+     * @note Complexity: O(b) in time, O(1) in space, where b is the number of
+     *       blocks allocated by the pool.
+     */
+    ~block_pool()
+    {
+        for (T* block : free_blocks_)
+        {
+            ::operator delete(block);
+        }
+    }
+
+    /**
+     * @brief Returns storage for block_size values.
+     * @note Complexity: O(1) in time (amortized), O(block_size) in space.
+     */
+    T* allocate()
+    {
+        if (free_blocks_.empty())
+        {
+            return static_cast<T*>(::operator new(block_size_ * sizeof(T)));
+        }
+
+        T* block = free_blocks_.back();
+        free_blocks_.pop_back();
+
+        return block;
+    }
+
+    /**
+     * @brief Returns a block (whose values were destroyed) to the pool.
+     * @note Complexity: O(1) in time (amortized), O(1) in space (amortized).
+     */
+    void deallocate(T* block)
+    {
+        free_blocks_.push_back(block);
+    }
+
+private:
+    size_t block_size_;
+    std::vector<T*> free_blocks_;
+};
+
+/**
+ * @brief A set of stacks with the same interface as stacks<T>, but on which
+ *        pop_at(k) takes O(1) time: instead of moving values from the later
+ *        stacks to refill the k-th stack, it leaves a hole in it. The holes
+ *        are removed by compact(), which is called on demand or automatically
+ *        once there are more holes than values (so a compaction, which takes
+ *        O(n) time, happens at most once every Ω(n) pop_at calls).
+ * @note Each stack is a contiguous block of values from a block_pool.
+ * @note Stacks keep their indices until the next compaction, even if they
+ *       become empty. After a compaction, all stacks except the last one are
+ *       full, as they would be with stacks<T>.
+ */
+template<typename T>
+class lazy_stacks
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param capacity The maximum number of values on each stack.
+     * @param auto_compact Whether to call compact() automatically when there
+     *        are more holes than values.
+     */
+    explicit lazy_stacks(const size_t capacity, const bool auto_compact = true)
+        : capacity_(capacity), auto_compact_(auto_compact), pool_(capacity)
+    {
+        /* nothing needs to be done here */
+    }
+
+    lazy_stacks(const lazy_stacks&) = delete;
+    lazy_stacks& operator=(const lazy_stacks&) = delete;
+
+    /**
+     * @brief Destructor.
+     * @note Complexity: O(n + b) in time, O(1) in space, where n is the total
+     *       number of elements stored and b is the number of stacks.
+     */
+    ~lazy_stacks()
+    {
+        for (size_t k = 0; k < num_stacks(); ++k)
+        {
+            for (size_t i = 0; i < sizes_[k]; ++i)
+            {
+                blocks_[k][i].~T();
+            }
+            pool_.deallocate(blocks_[k]);
+        }
+    }
+
+    /**
+     * @brief Pushes a value onto the last stack if possible, otherwise creates
+     *        a new stack for it.
+     * @note Complexity: O(1) in time (amortized), O(1) in space (amortized).
+     */
+    void push(const T& value)
+    {
+        if (stack_capacity() == 0)
+        {
+            return;
+        }
+
+        if (empty() == true || sizes_.back() == stack_capacity())
+        {
+            blocks_.push_back(pool_.allocate());
+            sizes_.push_back(0);
+        }
+
+        new (blocks_.back() + sizes_.back()) T(value);
+        ++sizes_.back();
+        ++size_;
+    }
+
+    /**
+     * @brief Pops an element from the last stack.
+     * @note Complexity: O(1) in time (amortized), O(1) in space.
+     */
+    void pop()
+    {
+        if (empty() == true)
+        {
+            return;
+        }
+
+        --sizes_.back();
+        blocks_.back()[sizes_.back()].~T();
+        --size_;
+
+        /* discard the last stacks while they are empty */
+        while (num_stacks() > 0 && sizes_.back() == 0)
+        {
+            pool_.deallocate(blocks_.back());
+            blocks_.pop_back();
+            sizes_.pop_back();
+
+            /* the slots missing on the new last stack are no longer holes */
+            if (num_stacks() > 0)
+            {
+                holes_ -= stack_capacity() - sizes_.back();
+            }
+        }
+    }
+
+    /**
+     * @brief Pops an element from the k-th stack (if it is not empty).
+     * @note Complexity: O(1) in time (amortized), O(1) in space.
+     */
+    void pop_at(const size_t k)
+    {
+        if (empty() == true)
+        {
+            return;
+        }
+
+        assert(k < num_stacks());
+
+        if (k + 1 == num_stacks())
+        {
+            pop();
+            return;
+        }
+
+        if (sizes_[k] == 0)
+        {
+            return;
+        }
+
+        --sizes_[k];
+        blocks_[k][sizes_[k]].~T();
+        --size_;
+        ++holes_;
+
+        if (auto_compact_ && holes_ > size_)
+        {
+            compact();
+        }
+    }
+
+    /**
+     * @brief Moves the values towards the first stacks (keeping their order)
+     *        so that all stacks except the last one are full.
+     * @note Complexity: O(n + b) in time, O(1) in space, where n is the total
+     *       number of elements stored and b is the number of stacks.
+     */
+    void compact()
+    {
+        if (holes_ == 0)
+        {
+            return;
+        }
+
+        /* the values only move backwards, to slots which are free */
+        size_t write_stack = 0;
+        size_t write_position = 0;
+
+        for (size_t k = 0; k < num_stacks(); ++k)
+        {
+            for (size_t i = 0; i < sizes_[k]; ++i)
+            {
+                T* source = blocks_[k] + i;
+                T* destination = blocks_[write_stack] + write_position;
+
+                if (source != destination)
+                {
+                    new (destination) T(std::move(*source));
+                    source->~T();
+                }
+
+                if (++write_position == stack_capacity())
+                {
+                    ++write_stack;
+                    write_position = 0;
+                }
+            }
+        }
+
+        const size_t stacks_needed = write_stack + (write_position > 0);
+
+        for (size_t k = stacks_needed; k < num_stacks(); ++k)
+        {
+            pool_.deallocate(blocks_[k]);
+        }
+
+        blocks_.resize(stacks_needed);
+        sizes_.assign(stacks_needed, stack_capacity());
+
+        if (write_position > 0)
+        {
+            sizes_.back() = write_position;
+        }
+
+        holes_ = 0;
+    }
+
+    /**
+     * @brief Returns the element on the top of the last stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T& top() const
+    {
+        assert(empty() == false);
+
+        return blocks_.back()[sizes_.back() - 1];
+    }
+
+    /**
+     * @brief Returns true if no stacks have been created, false otherwise.
+     * @note Complexity: O(1) in both time and space.
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the maximum capacity of a single stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t stack_capacity() const
+    {
+        return capacity_;
+    }
+
+    /**
+     * @brief Returns the total number of stacks created.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t num_stacks() const
+    {
+        return blocks_.size();
+    }
+
+    /**
+     * @brief Returns the number of elements on the k-th stack.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t stack_size(const size_t k) const
+    {
+        return sizes_[k];
+    }
+
+    /**
+     * @brief Returns the number of free slots on all stacks except the last.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t holes() const
+    {
+        return holes_;
+    }
+
+    /**
+     * @brief Returns the total number of elements over all stacks.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    size_t capacity_;
+    bool auto_compact_;
+
+    block_pool<T> pool_;
+
+    /* the k-th stack holds the values blocks_[k][0..sizes_[k]) */
+    std::vector<T*> blocks_;
+    std::vector<size_t> sizes_;
+
+    size_t size_ = 0;
+    size_t holes_ = 0;
+};
+
 #endif /* __STACKS_HPP__ */
@@ -0,0 +1,131 @@
+#ifndef __HANOI_HPP__
+#define __HANOI_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/** @brief A move of the towers of Hanoi: a disk goes from a rod to another. */
+struct hanoi_move
+{
+    /* the disks are labeled 0..n-1 from the smallest to the largest */
+    unsigned disk;
+
+    /* the rods are labeled 0 (origin), 1 (helper) and 2 (target) */
+    unsigned from;
+    unsigned to;
+};
+
+/**
+ * @brief Generates the moves of the optimal solution of the towers of Hanoi
+ *        with n disks (n < 64), moving all disks from rod 0 to rod 2.
+ * @note The k-th move (counting from 1) is computed directly from the binary
+ *       representation of k, so the sequence can be generated without
+ *       recursion or rods, and can start from any move:
+ *         - the moved disk is the number of trailing zeros of k (the smallest
+ *           disk moves every other time, the next one every four times, ...)
+ *         - the disk moves from rod (k & (k-1)) mod 3 to rod ((k | (k-1)) + 1)
+ *           mod 3, which solves the puzzle onto rod 2 if n is odd and onto rod
+ *           1 if n is even (so rods 1 and 2 are swapped when n is even).
+ */
+class hanoi_moves
+{
+public:
+    /** @brief Constructor for the moves of a puzzle with n disks. */
+    explicit hanoi_moves(const unsigned n)
+        : n_(n), size_((uint64_t(1) << n) - 1)
+    {
+        assert(n < 64);
+
+        rods_[0] = 0;
+        rods_[1] = (n % 2 == 0) ? 2 : 1;
+        rods_[2] = (n % 2 == 0) ? 1 : 2;
+    }
+
+    /**
+     * @brief Returns the k-th move of the solution (counting from 0).
+     * @note Complexity: O(1) in both time and space.
+     */
+    hanoi_move operator[](const uint64_t k) const
+    {
+        assert(k < size_);
+
+        const uint64_t m = k + 1;
+
+        hanoi_move move;
+        move.disk = __builtin_ctzll(m);
+        move.from = rods_[(m & (m - 1)) % 3];
+        move.to = rods_[((m | (m - 1)) + 1) % 3];
+
+        return move;
+    }
+
+    /**
+     * @brief Sets the next move to be generated to the k-th move (k may be
+     *        equal to the number of moves, in which case all moves are done).
+     * @note Complexity: O(1) in both time and space.
+     */
+    void seek(const uint64_t k)
+    {
+        assert(k <= size_);
+        position_ = k;
+    }
+
+    /**
+     * @brief Writes the next (up to) count moves to a buffer.
+     * @return The number of moves written (smaller than count only when the
+     *         solution ends).
+     * @note Complexity: O(count) in time, O(1) in space.
+     */
+    size_t next(hanoi_move* buffer, size_t count)
+    {
+        if (count > size_ - position_)
+        {
+            count = size_ - position_;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffer[i] = (*this)[position_ + i];
+        }
+
+        position_ += count;
+
+        return count;
+    }
+
+    /** @brief Returns the index of the next move to be generated. */
+    uint64_t position() const
+    {
+        return position_;
+    }
+
+    /** @brief Returns true if all moves were generated, false otherwise. */
+    bool done() const
+    {
+        return position_ == size_;
+    }
+
+    /** @brief Returns the number of moves of the solution (2^n - 1). */
+    uint64_t size() const
+    {
+        return size_;
+    }
+
+    /** @brief Returns the number of disks. */
+    unsigned disks() const
+    {
+        return n_;
+    }
+
+private:
+    unsigned n_;
+    uint64_t size_;
+
+    /* maps the rods of the formula to the actual rods (swapped for even n) */
+    unsigned rods_[3];
+
+    uint64_t position_ = 0;
+};
+
+#endif /* __HANOI_HPP__ */
@@ -4,9 +4,18 @@
  *       Your solution must use stacks to represent each rod.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <random>
 #include <stack>
+#include <vector>
+#include "hanoi.hpp"
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Solves the Hanoi problem recursively.
@@ -58,6 +67,95 @@ void solve(std::stack<size_t>& A,
     solve(B, A, C, n - 1);
 }
 
+/**
+ * @brief Solves the Hanoi problem iteratively, applying the moves generated
+ *        by hanoi_moves to the rods.
+ * @param A The origin rod containing the n disks which must be moved.
+ * @param B The helper rod.
+ * @param C The target rod to which the n disks from A must be moved.
+ * @note Complexity: O(2^n) in time, O(1) in space (besides the rods).
+ */
+void solve_iterative(std::stack<size_t>& A,
+                     std::stack<size_t>& B,
+                     std::stack<size_t>& C)
+{
+    std::stack<size_t>* rods[3] = {&A, &B, &C};
+
+    hanoi_moves moves(A.size());
+    hanoi_move buffer[256];
+
+    while (size_t count = moves.next(buffer, 256))
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            rods[buffer[i].to]->push(rods[buffer[i].from]->top());
+            rods[buffer[i].from]->pop();
+        }
+    }
+}
+
+#ifdef BENCHMARK
+
+/*
+ * The input size is the number of disks n. The recursive solution moves all
+ * 2^n - 1 disks between std::stack rods; the move generator is measured by
+ * generating batches of 2^16 moves (or all of them, for small n) starting
+ * from random positions of the solution, so it can also run for large n.
+ */
+
+const std::vector<size_t> sizes = {4, 8, 12, 16, 20, 24, 28, 32, 36, 40};
+
+void bench_solve_recursive(benchmark::state& state)
+{
+    const size_t n = state.size();
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        std::stack<size_t> A, B, C;
+        for (size_t i = 0; i < n; ++i)
+        {
+            A.push(n - i - 1);
+        }
+        state.resume_timing();
+
+        solve(A, B, C, n);
+        benchmark::do_not_optimize(C.top());
+    }
+
+    state.set_items_processed((uint64_t(1) << n) - 1);
+}
+
+void bench_hanoi_moves_batch(benchmark::state& state)
+{
+    hanoi_moves moves(state.size());
+
+    const size_t batch_size = std::min<uint64_t>(moves.size(), 1 << 16);
+    std::vector<hanoi_move> buffer(batch_size);
+
+    std::mt19937_64 generator(state.size());
+    std::uniform_int_distribution<uint64_t> distribution(
+        0, moves.size() - batch_size);
+
+    while (state.keep_running())
+    {
+        moves.seek(distribution(generator));
+        benchmark::do_not_optimize(moves.next(buffer.data(), batch_size));
+        benchmark::do_not_optimize(buffer.back());
+    }
+
+    state.set_items_processed(batch_size);
+}
+
+/* the recursive solution only runs on smaller puzzles */
+REGISTER_BENCHMARK(bench_solve_recursive,
+                   std::vector<size_t>(sizes.begin(), sizes.begin() + 6));
+REGISTER_BENCHMARK(bench_hanoi_moves_batch, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 20; ++n)
@@ -84,8 +182,120 @@ int main()
             C.pop();
         }
 
+        /* the iterative solution does the same */
+        for (size_t i = 0; i < n; ++i)
+        {
+            A.push(n - i - 1);
+        }
+
+        solve_iterative(A, B, C);
+
+        assert(A.size() == 0);
+        assert(B.size() == 0);
+        assert(C.size() == n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert(C.top() == i);
+            C.pop();
+        }
+
         std::cout << "passed test for tower of height " << n << std::endl;
     }
 
+    std::random_device device;
+    std::mt19937_64 generator(device());
+
+    for (unsigned n = 0; n <= 16; ++n)
+    {
+        hanoi_moves moves(n);
+
+        assert(moves.size() == (uint64_t(1) << n) - 1);
+
+        /* the disks on each rod (as a stack from bottom to top) */
+        std::vector<unsigned> rods[3];
+
+        for (unsigned i = 0; i < n; ++i)
+        {
+            rods[0].push_back(n - i - 1);
+        }
+
+        /* every move must be legal (and the sequence has the optimal length) */
+        std::vector<hanoi_move> buffer(7);
+
+        for (uint64_t k = 0; moves.done() == false;)
+        {
+            const size_t count = moves.next(buffer.data(), buffer.size());
+
+            assert(count == std::min<uint64_t>(7, moves.size() - k));
+
+            for (size_t i = 0; i < count; ++i, ++k)
+            {
+                const hanoi_move move = buffer[i];
+
+                assert(move.from < 3 && move.to < 3 && move.from != move.to);
+                assert(rods[move.from].empty() == false);
+                assert(rods[move.from].back() == move.disk);
+                assert(rods[move.to].empty() ||
+                       rods[move.to].back() > move.disk);
+
+                rods[move.to].push_back(move.disk);
+                rods[move.from].pop_back();
+
+                /* random access gives the same moves */
+                assert(moves[k].disk == move.disk);
+                assert(moves[k].from == move.from);
+                assert(moves[k].to == move.to);
+            }
+        }
+
+        assert(moves.next(buffer.data(), buffer.size()) == 0);
+        assert(rods[0].empty() && rods[1].empty());
+        assert(rods[2].size() == n);
+
+        std::cout << "passed move generator test for tower of height " << n
+                  << std::endl;
+    }
+
+    /* seeking into the solutions of large puzzles */
+    for (unsigned n = 1; n < 64; ++n)
+    {
+        hanoi_moves moves(n);
+
+        std::uniform_int_distribution<uint64_t> distribution(0, moves.size());
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            const uint64_t k = distribution(generator);
+            moves.seek(k);
+
+            hanoi_move move;
+            const size_t count = moves.next(&move, 1);
+
+            assert(count == (k < moves.size() ? 1 : 0));
+            assert(moves.position() == k + count);
+
+            if (count == 1)
+            {
+                /* move k (counting from 1) moves the disk ctz(k) */
+                assert(move.disk < n);
+                assert(((k + 1) >> move.disk) % 2 == 1);
+                assert(((k + 1) & ((uint64_t(1) << move.disk) - 1)) == 0);
+                assert(move.from != move.to);
+
+                /* the middle move takes the largest disk to the target */
+                if (k == moves.size() / 2)
+                {
+                    assert(move.disk == n - 1);
+                    assert(move.from == 0 && move.to == 2);
+                }
+            }
+        }
+    }
+
+    std::cout << "passed seek tests" << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -0,0 +1,276 @@
+#ifndef __AGGREGATE_QUEUE_HPP__
+#define __AGGREGATE_QUEUE_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+ * A monoid is a type with a static function combine(a, b) which is
+ * associative (but not necessarily commutative); for a queue holding the
+ * values v1, v2, ..., vn (from front to back), the aggregate of the queue is
+ * combine(...combine(combine(v1, v2), v3)..., vn). The monoids below have the
+ * same interface as those of aggregate_stack (3.02), so a monoid written for
+ * one container also works with the other (the queue ignores the optional
+ * selective trait which aggregate_stack checks for).
+ */
+
+/** @brief Monoid which aggregates values into their minimum. */
+template<typename T>
+struct min_monoid
+{
+    static constexpr bool selective = true;
+
+    static const T& combine(const T& a, const T& b)
+    {
+        return std::min(a, b);
+    }
+};
+
+/** @brief Monoid which aggregates values into their maximum. */
+template<typename T>
+struct max_monoid
+{
+    static constexpr bool selective = true;
+
+    static const T& combine(const T& a, const T& b)
+    {
+        return std::max(a, b);
+    }
+};
+
+/** @brief Monoid which aggregates values into their sum. */
+template<typename T>
+struct sum_monoid
+{
+    static T combine(const T& a, const T& b)
+    {
+        return a + b;
+    }
+};
+
+/**
+ * @brief A queue stored in a ring buffer which can return the aggregate of
+ *        all its values under a monoid (e.g. the minimum of a sliding window).
+ * @note The aggregate is computed with the two-stacks technique, without
+ *       moving any values: the queue is split into a front part, for which
+ *       the aggregate of every suffix is stored, and a back part, for which
+ *       only the aggregate of the whole part is stored. Pushes extend the back
+ *       part, pops shrink the front part, and when the front part is empty, a
+ *       pop turns the whole queue into the front part (computing its suffix
+ *       aggregates). Every value is part of one such conversion, so pushes and
+ *       pops take O(1) time (amortized), and the aggregate is the combination
+ *       of the first suffix aggregate with the aggregate of the back part.
+ * @note T must be default-constructible and copy-assignable.
+ */
+template<typename T, typename Monoid = min_monoid<T>>
+class aggregate_queue
+{
+public:
+    /** @brief Constructor for a queue with a given initial capacity. */
+    explicit aggregate_queue(const size_t capacity = 16)
+    {
+        /* the capacity is a power of two so positions are masked */
+        size_t power = 1;
+        while (power < capacity)
+        {
+            power *= 2;
+        }
+
+        values_.resize(power);
+        suffix_.resize(power);
+    }
+
+    /**
+     * @brief Pushes a value onto the back of the queue.
+     * @note Complexity: O(1) in time (amortized), O(1) in space (amortized).
+     */
+    void push(const T& value)
+    {
+        emplace(value);
+    }
+
+    void push(T&& value)
+    {
+        emplace(std::move(value));
+    }
+
+    /**
+     * @brief Constructs a value (from the given arguments) on the back of the
+     *        queue.
+     * @note Complexity: O(1) in time (amortized), O(1) in space (amortized).
+     */
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        if (size() == values_.size())
+        {
+            /* the arguments may refer to values which are about to move */
+            T moved(std::forward<Args>(args)...);
+            grow();
+
+            values_[tail_ & mask()] = std::move(moved);
+        }
+        else
+        {
+            values_[tail_ & mask()] = T(std::forward<Args>(args)...);
+        }
+
+        const T& value = values_[tail_ & mask()];
+
+        back_aggregate_ = (middle_ == tail_)
+                              ? value
+                              : Monoid::combine(back_aggregate_, value);
+        ++tail_;
+    }
+
+    /**
+     * @brief Returns the value on the front of the queue.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T& front() const
+    {
+        assert(empty() == false);
+        return values_[head_ & mask()];
+    }
+
+    /**
+     * @brief Returns the value on the back of the queue.
+     * @note Complexity: O(1) in both time and space.
+     */
+    const T& back() const
+    {
+        assert(empty() == false);
+        return values_[(tail_ - 1) & mask()];
+    }
+
+    /**
+     * @brief Pops a value from the front of the queue.
+     * @note Complexity: O(1) in time (amortized), O(1) in space.
+     */
+    void pop()
+    {
+        assert(empty() == false);
+
+        if (head_ == middle_)
+        {
+            flip();
+        }
+
+        ++head_;
+    }
+
+    /**
+     * @brief Returns the aggregate of all values in the queue.
+     * @note Complexity: O(1) in both time and space.
+     */
+    T aggregate() const
+    {
+        assert(empty() == false);
+
+        if (head_ == middle_)
+        {
+            return back_aggregate_;
+        }
+
+        if (middle_ == tail_)
+        {
+            return suffix_[head_ & mask()];
+        }
+
+        return Monoid::combine(suffix_[head_ & mask()], back_aggregate_);
+    }
+
+    /**
+     * @brief Returns the number of elements in the queue.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t size() const
+    {
+        return tail_ - head_;
+    }
+
+    /**
+     * @brief Returns true if the queue is empty, false otherwise.
+     * @note Complexity: O(1) in both time and space.
+     */
+    bool empty() const
+    {
+        return head_ == tail_;
+    }
+
+private:
+    size_t mask() const
+    {
+        return values_.size() - 1;
+    }
+
+    /**
+     * @brief Turns the whole queue into its front part.
+     * @note Complexity: O(n) in time, O(1) in space, where n is the number
+     *       of elements in the queue.
+     */
+    void flip()
+    {
+        middle_ = tail_;
+
+        if (head_ == tail_)
+        {
+            return;
+        }
+
+        suffix_[(tail_ - 1) & mask()] = values_[(tail_ - 1) & mask()];
+
+        for (size_t i = tail_ - 1; i-- > head_;)
+        {
+            suffix_[i & mask()] = Monoid::combine(values_[i & mask()],
+                                                  suffix_[(i + 1) & mask()]);
+        }
+    }
+
+    /**
+     * @brief Doubles the capacity of the ring buffer.
+     * @note Complexity: O(n) in both time and space, where n is the number of
+     *       elements in the queue.
+     */
+    void grow()
+    {
+        std::vector<T> values(2 * values_.size());
+        std::vector<T> suffix(2 * values_.size());
+
+        /* the values are moved to the positions [0, n) */
+        for (size_t i = head_; i != tail_; ++i)
+        {
+            values[i - head_] = std::move(values_[i & mask()]);
+            suffix[i - head_] = std::move(suffix_[i & mask()]);
+        }
+
+        values_.swap(values);
+        suffix_.swap(suffix);
+
+        middle_ -= head_;
+        tail_ -= head_;
+        head_ = 0;
+    }
+
+    std::vector<T> values_;
+
+    /* suffix_[i] is the aggregate of the values at positions [i, middle_) */
+    std::vector<T> suffix_;
+
+    /* the aggregate of the values at positions [middle_, tail_) */
+    T back_aggregate_{};
+
+    /*
+     * the queue occupies the positions [head_, tail_) (modulo the capacity),
+     * with the front part at [head_, middle_) and the back part at
+     * [middle_, tail_)
+     */
+    size_t head_ = 0;
+    size_t middle_ = 0;
+    size_t tail_ = 0;
+};
+
+#endif /* __AGGREGATE_QUEUE_HPP__ */
@@ -3,45 +3,268 @@
  *        operations).
  */
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "aggregate_queue.hpp"
 #include "two_stacks_queue.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
+/** @brief Monoid which concatenates strings (it is not commutative). */
+struct concatenation_monoid
+{
+    static std::string combine(const std::string& a, const std::string& b)
+    {
+        return a + b;
+    }
+};
+
+#ifdef BENCHMARK
+
+/*
+ * The queues hold n values, and each iteration reads the front and then the
+ * back of the queue, which makes two_stacks_queue move all values from one of
+ * its stacks to the other on every read.
+ */
+
+template<typename Queue>
+void bench_alternating(benchmark::state& state)
+{
+    Queue Q;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        Q.push(i);
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(Q.front());
+        benchmark::do_not_optimize(Q.back());
+    }
+
+    state.set_items_processed(2);
+}
+
+void bench_alternating_two_stacks_queue(benchmark::state& state)
+{
+    bench_alternating<two_stacks_queue<size_t>>(state);
+}
+
+void bench_alternating_aggregate_queue(benchmark::state& state)
+{
+    bench_alternating<aggregate_queue<size_t>>(state);
+}
+
+/* minimum of a sliding window of n values over a stream of random values */
+void bench_window_min(benchmark::state& state)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<int> distribution;
+
+    std::vector<int> stream(1 << 16);
+    for (int& value : stream)
+    {
+        value = distribution(generator);
+    }
+
+    aggregate_queue<int, min_monoid<int>> Q;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        Q.push(stream[i % stream.size()]);
+    }
+
+    size_t i = state.size();
+
+    while (state.keep_running())
+    {
+        Q.push(stream[i++ % stream.size()]);
+        Q.pop();
+        benchmark::do_not_optimize(Q.aggregate());
+    }
+
+    state.set_items_processed(1);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 20, 4);
+
+REGISTER_BENCHMARK(bench_alternating_two_stacks_queue,
+                   benchmark::range(16, 1 << 14, 4));
+REGISTER_BENCHMARK(bench_alternating_aggregate_queue, sizes);
+REGISTER_BENCHMARK(bench_window_min, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
+/**
+ * @brief Runs random pushes and pops on an aggregate_queue, comparing it (and
+ *        its aggregate) with a std::deque holding the same values.
+ */
+template<typename T, typename Monoid, typename Generator>
+void random_aggregate_test(const size_t n, Generator random_value)
+{
+    static std::random_device device;
+    static std::mt19937 generator(device());
+
+    std::bernoulli_distribution push(0.55);
+
+    aggregate_queue<T, Monoid> Q(n % 5);
+    std::deque<T> R;
+
+    for (size_t i = 0; i < 4 * n; ++i)
+    {
+        if (push(generator) || R.empty())
+        {
+            R.push_back(random_value());
+            Q.push(R.back());
+        }
+        else
+        {
+            R.pop_front();
+            Q.pop();
+        }
+
+        assert(Q.size() == R.size());
+
+        if (R.empty() == false)
+        {
+            assert(Q.front() == R.front());
+            assert(Q.back() == R.back());
+
+            T aggregate = R.front();
+            for (size_t j = 1; j < R.size(); ++j)
+            {
+                aggregate = Monoid::combine(aggregate, R[j]);
+            }
+
+            assert(Q.aggregate() == aggregate);
+        }
+    }
+}
+
 int main()
 {
+    std::random_device device;
+    std::mt19937 generator(device());
+
     for (size_t n = 0; n <= 100; ++n)
     {
         two_stacks_queue<size_t> Q;
+        aggregate_queue<size_t, max_monoid<size_t>> A;
 
         /* push elements onto the queue */
         for (size_t i = 0; i < n; ++i)
         {
             assert(Q.size() == i);
+            assert(A.size() == i);
 
             Q.push(i);
+            A.push(i);
 
             /* run tests on Q without modifying it */
             two_stacks_queue<size_t> R = Q;
             assert(R.front() == 0);
             assert(R.back() == i);
+
+            assert(A.front() == 0);
+            assert(A.back() == i);
+            assert(A.aggregate() == i);
         }
 
         /* pop all elements from the queue */
         for (size_t i = 0; i < n; ++i)
         {
             assert(Q.size() == n - i);
+            assert(A.size() == n - i);
 
             /* run tests on Q without modifying it */
             two_stacks_queue<size_t> R = Q;
             assert(R.front() == i);
             assert(R.back() == n - 1);
 
+            assert(A.front() == i);
+            assert(A.back() == n - 1);
+            assert(A.aggregate() == n - 1);
+
             Q.pop();
+            A.pop();
         }
 
         assert(Q.empty() == true);
+        assert(A.empty() == true);
+
+        std::uniform_int_distribution<int> distribution(-100, 100);
+        auto random_int = [&]() { return distribution(generator); };
+        auto random_char = [&]() {
+            return std::string(1, 'a' + (distribution(generator) + 100) % 26);
+        };
+
+        for (int i = 0; i < 20; ++i)
+        {
+            random_aggregate_test<int, min_monoid<int>>(n, random_int);
+            random_aggregate_test<int, max_monoid<int>>(n, random_int);
+            random_aggregate_test<int, sum_monoid<int>>(n, random_int);
+            random_aggregate_test<std::string, concatenation_monoid>(
+                n, random_char);
+        }
 
         std::cout << "passed tests for queues of length " << n << std::endl;
     }
 
+    /* values of the queue itself pushed when the ring buffer must grow */
+    for (size_t capacity = 1; capacity <= 8; capacity *= 2)
+    {
+        aggregate_queue<std::string, min_monoid<std::string>> S(capacity);
+        std::deque<std::string> D;
+
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            S.push(std::string(20, 'b' + i));
+            D.push_back(std::string(20, 'b' + i));
+        }
+
+        /* the queue is full, so each push grows it */
+        for (int i = 0; i < 4; ++i)
+        {
+            const std::string front = S.front();
+            S.push(S.front());
+            D.push_back(front);
+            assert(S.back() == front);
+
+            const std::string back = S.back();
+            S.push(S.back());
+            D.push_back(back);
+            assert(S.back() == back);
+
+            /* the capacity is the smallest power of two holding the values */
+            while ((S.size() & (S.size() - 1)) != 0)
+            {
+                S.push(std::string(20, 'a'));
+                D.push_back(std::string(20, 'a'));
+            }
+        }
+
+        while (S.empty() == false)
+        {
+            assert(S.front() == D.front());
+            assert(S.aggregate() == *std::min_element(D.begin(), D.end()));
+
+            S.pop();
+            D.pop_front();
+        }
+    }
+
+    std::cout << "passed tests for values pushed from the queue" << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -0,0 +1,413 @@
+#ifndef __EXTERNAL_SORT_HPP__
+#define __EXTERNAL_SORT_HPP__
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A loser tree (tournament tree) which repeatedly selects the smallest
+ *        of k sequences, e.g. for k-way merging.
+ * @note The sequences are identified by their indices on [0,k), and less(i, j)
+ *       must return true if the current head of sequence i is smaller than the
+ *       current head of sequence j (exhausted sequences compare larger than
+ *       all others). Each internal node stores the loser of the match played
+ *       there, so after the winner's sequence advances, the new winner is
+ *       found by replaying the matches on its path to the root only: O(log k)
+ *       comparisons, without comparing against the sibling winners (as a
+ *       binary heap would).
+ */
+template<typename Less>
+class loser_tree
+{
+public:
+    /**
+     * @brief Constructor for a tree over k sequences (k > 0).
+     * @note Complexity: O(k) in both time and space.
+     */
+    loser_tree(const size_t k, const Less& less)
+        : k_(k), less_(less), tree_(k)
+    {
+        /* winners of the matches, with the leaves at positions [k, 2k) */
+        std::vector<size_t> winners(2 * k);
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            winners[k + i] = i;
+        }
+
+        for (size_t node = k - 1; node > 0; --node)
+        {
+            size_t winner = winners[2 * node];
+            size_t loser = winners[2 * node + 1];
+
+            if (less_(loser, winner))
+            {
+                std::swap(winner, loser);
+            }
+
+            winners[node] = winner;
+            tree_[node] = loser;
+        }
+
+        tree_[0] = (k > 1) ? winners[1] : 0;
+    }
+
+    /**
+     * @brief Returns the index of the sequence with the smallest head.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t winner() const
+    {
+        return tree_[0];
+    }
+
+    /**
+     * @brief Updates the tree after the head of the winner's sequence changed.
+     * @note Complexity: O(log k) in time, O(1) in space.
+     */
+    void replay()
+    {
+        size_t winner = tree_[0];
+
+        for (size_t node = (k_ + winner) / 2; node > 0; node /= 2)
+        {
+            if (less_(tree_[node], winner))
+            {
+                std::swap(tree_[node], winner);
+            }
+        }
+
+        tree_[0] = winner;
+    }
+
+private:
+    size_t k_;
+    Less less_;
+
+    /* tree_[0] is the overall winner, tree_[1..k) the losers of the matches */
+    std::vector<size_t> tree_;
+};
+
+/**
+ * @brief A temporary file holding runs of values (written in binary, one
+ *        after the other), which is deleted when closed.
+ * @note The file is only created by the first append.
+ */
+template<typename T>
+class spill_file
+{
+public:
+    spill_file() = default;
+
+    spill_file(const spill_file&) = delete;
+    spill_file& operator=(const spill_file&) = delete;
+
+    spill_file(spill_file&& other) noexcept
+        : file_(other.file_), size_(other.size_)
+    {
+        other.file_ = nullptr;
+        other.size_ = 0;
+    }
+
+    spill_file& operator=(spill_file&& other) noexcept
+    {
+        std::swap(file_, other.file_);
+        std::swap(size_, other.size_);
+
+        return *this;
+    }
+
+    ~spill_file()
+    {
+        if (file_ != nullptr)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    /**
+     * @brief Appends the values [first, first + count) to the file.
+     * @note All values must be appended before the first read.
+     */
+    void append(const T* first, const size_t count)
+    {
+        if (file_ == nullptr)
+        {
+            file_ = std::tmpfile();
+
+            if (file_ == nullptr)
+            {
+                throw std::runtime_error("cannot create temporary file");
+            }
+        }
+
+        if (std::fwrite(first, sizeof(T), count, file_) != count)
+        {
+            throw std::runtime_error("cannot write temporary file");
+        }
+
+        size_ += count;
+    }
+
+    /** @brief Reads count values, starting from the given value offset. */
+    void read(const size_t offset, T* buffer, const size_t count)
+    {
+        if (std::fseek(file_, offset * sizeof(T), SEEK_SET) != 0 ||
+            std::fread(buffer, sizeof(T), count, file_) != count)
+        {
+            throw std::runtime_error("cannot read temporary file");
+        }
+    }
+
+    /** @brief Returns the number of values in the file. */
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    std::FILE* file_ = nullptr;
+    size_t size_ = 0;
+};
+
+/** @brief A sorted run of values, stored in a spill_file. */
+struct run
+{
+    size_t offset;
+    size_t size;
+};
+
+/** @brief Reads the values of a run through a buffer of a given size. */
+template<typename T>
+class run_reader
+{
+public:
+    run_reader(spill_file<T>& file, const run r, const size_t buffer_size)
+        : file_(&file),
+          offset_(r.offset),
+          remaining_(r.size),
+          buffer_(buffer_size)
+    {
+        refill();
+    }
+
+    /** @brief Returns true if all values of the run were read. */
+    bool empty() const
+    {
+        return position_ == buffer_end_;
+    }
+
+    /** @brief Returns the current value. */
+    const T& head() const
+    {
+        return buffer_[position_];
+    }
+
+    /** @brief Advances to the next value. */
+    void next()
+    {
+        if (++position_ == buffer_end_)
+        {
+            refill();
+        }
+    }
+
+private:
+    void refill()
+    {
+        const size_t count = std::min(remaining_, buffer_.size());
+
+        file_->read(offset_, buffer_.data(), count);
+
+        offset_ += count;
+        remaining_ -= count;
+        position_ = 0;
+        buffer_end_ = count;
+    }
+
+    spill_file<T>* file_;
+    size_t offset_;
+    size_t remaining_;
+
+    std::vector<T> buffer_;
+    size_t position_ = 0;
+    size_t buffer_end_ = 0;
+};
+
+/**
+ * @brief Merges the runs [first, last) of a file, passing the merged values to
+ *        output (in order), reading each run through a buffer of a given size.
+ */
+template<typename T, typename Compare, typename Output>
+void merge_runs(spill_file<T>& file,
+                const run* first,
+                const run* last,
+                const size_t buffer_size,
+                const Compare& compare,
+                Output& output)
+{
+    std::vector<run_reader<T>> readers;
+    readers.reserve(last - first);
+
+    for (const run* r = first; r != last; ++r)
+    {
+        readers.emplace_back(file, *r, buffer_size);
+    }
+
+    /* exhausted runs compare larger than all others */
+    auto less = [&](const size_t i, const size_t j) {
+        if (readers[i].empty() || readers[j].empty())
+        {
+            return readers[j].empty() && readers[i].empty() == false;
+        }
+        return compare(readers[i].head(), readers[j].head());
+    };
+
+    loser_tree<decltype(less)> tree(readers.size(), less);
+
+    while (readers[tree.winner()].empty() == false)
+    {
+        run_reader<T>& reader = readers[tree.winner()];
+
+        output(reader.head());
+        reader.next();
+
+        tree.replay();
+    }
+}
+
+/**
+ * @brief Sorts the values produced by input using at most (about) a given
+ *        amount of memory, and passes them to output in sorted order.
+ * @param input A function which stores the next value in its argument and
+ *        returns true, or returns false if there are no more values.
+ * @param output A function which is called with each value, in sorted order.
+ * @param memory_budget The memory (in bytes) available for buffers.
+ * @param compare The strict weak ordering to sort by.
+ * @return The number of sorted runs spilled to a temporary file (0 if all
+ *         values fit in memory).
+ * @note If the values fit in the memory budget, they are sorted in memory.
+ *       Otherwise, the input is split into sorted runs which fill the budget
+ *       and are written to a temporary file, then the runs are merged with a
+ *       loser tree, at most fan_in runs at a time (so that each run is read in
+ *       blocks of at least 64 KiB); passes over the data which merge groups
+ *       of runs into longer runs are made until a single merge remains.
+ * @note Complexity: O(n log n) in time, O(m) in memory and O(n) in disk space,
+ *       where n is the number of values and m is the memory budget; the data
+ *       is read and written O(log_f(n/m)) times, where f is the fan-in.
+ */
+template<typename T, typename Input, typename Output, typename Compare>
+size_t external_sort(Input input,
+                     Output output,
+                     const size_t memory_budget,
+                     const Compare& compare)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "runs are written to files as raw bytes");
+
+    /* the number of values which fit in the memory budget */
+    const size_t capacity = std::max<size_t>(memory_budget / sizeof(T), 16);
+
+    /* the buffer grows as needed, so small inputs stay cheap to sort */
+    std::vector<T> buffer;
+
+    spill_file<T> file;
+    std::vector<run> runs;
+
+    /* the next value is read ahead to tell whether the input is exhausted */
+    T value;
+    bool more = input(value);
+
+    /* step 1: sort the values in runs which fit in memory */
+    do
+    {
+        buffer.clear();
+
+        while (more && buffer.size() < capacity)
+        {
+            if (buffer.size() == buffer.capacity())
+            {
+                buffer.reserve(std::min(2 * buffer.size() + 16, capacity));
+            }
+
+            buffer.push_back(value);
+            more = input(value);
+        }
+
+        std::sort(buffer.begin(), buffer.end(), compare);
+
+        if (more == false && runs.empty())
+        {
+            for (const T& x : buffer)
+            {
+                output(x);
+            }
+
+            return 0;
+        }
+
+        if (buffer.empty() == false)
+        {
+            runs.push_back(run{file.size(), buffer.size()});
+            file.append(buffer.data(), buffer.size());
+        }
+    } while (more);
+
+    std::vector<T>().swap(buffer);
+
+    const size_t num_runs = runs.size();
+
+    /* step 2: merge the runs, with a buffer for each input and the output */
+    const size_t block_size = std::max<size_t>((64 << 10) / sizeof(T), 1);
+    const size_t fan_in = std::max<size_t>(capacity / block_size, 3) - 1;
+    const size_t buffer_size = std::max<size_t>(capacity / (fan_in + 1), 1);
+
+    while (runs.size() > fan_in)
+    {
+        /* each pass writes its (fewer, longer) runs to a new file */
+        spill_file<T> merged_file;
+        std::vector<run> merged_runs;
+
+        std::vector<T> merged_buffer;
+        merged_buffer.reserve(buffer_size);
+
+        auto append = [&](const T& x) {
+            merged_buffer.push_back(x);
+
+            if (merged_buffer.size() == buffer_size)
+            {
+                merged_file.append(merged_buffer.data(), merged_buffer.size());
+                merged_buffer.clear();
+            }
+        };
+
+        for (size_t i = 0; i < runs.size(); i += fan_in)
+        {
+            const size_t last = std::min(i + fan_in, runs.size());
+            const size_t offset = merged_file.size() + merged_buffer.size();
+
+            merge_runs(
+                file, &runs[i], &runs[0] + last, buffer_size, compare, append);
+
+            merged_runs.push_back(
+                run{offset,
+                    merged_file.size() + merged_buffer.size() - offset});
+        }
+
+        merged_file.append(merged_buffer.data(), merged_buffer.size());
+
+        file = std::move(merged_file);
+        runs.swap(merged_runs);
+    }
+
+    merge_runs(
+        file, &runs[0], &runs[0] + runs.size(), buffer_size, compare, output);
+
+    return num_runs;
+}
+
+#endif /* __EXTERNAL_SORT_HPP__ */
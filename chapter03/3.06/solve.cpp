@@ -4,10 +4,19 @@
  *       push, pop, top and is_empty operations of your stack implementation.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <random>
 #include <stack>
+#include <vector>
+#include "external_sort.hpp"
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Sorts a stack A with n elements in ascending order (i.e., the stack
@@ -45,6 +54,142 @@ void sort_stack(std::stack<T>& A)
     A = B;
 }
 
+/**
+ * @brief Sorts a stack A with n elements in ascending order (i.e., the stack
+ *        top will be its minimum element after sorting), using at most (about)
+ *        a given amount of memory besides the stack itself.
+ * @param A Any stack with push, pop, top and empty operations (e.g. a
+ *        std::stack) holding trivially copyable values.
+ * @param memory_budget The memory (in bytes) available for sorting.
+ * @return The number of sorted runs spilled to a temporary file (0 if the
+ *         stack was sorted in memory).
+ * @note The values are popped from A into runs which fill the memory budget,
+ *       and then merged (see external_sort) from the largest to the smallest,
+ *       being pushed back onto A in this order; if A fits in the budget, it is
+ *       simply sorted in memory.
+ * @note Complexity: O(n log n) in time, O(m) in memory and O(n) in disk space,
+ *       where m is the memory budget.
+ */
+template<typename Stack>
+size_t sort_stack_external(Stack& A, const size_t memory_budget = 256 << 20)
+{
+    typedef typename Stack::value_type T;
+
+    auto input = [&](T& value) {
+        if (A.empty())
+        {
+            return false;
+        }
+
+        value = A.top();
+        A.pop();
+
+        return true;
+    };
+
+    auto output = [&](const T& value) { A.push(value); };
+
+    return external_sort<T>(input, output, memory_budget, std::greater<T>());
+}
+
+#ifdef BENCHMARK
+
+/*
+ * Each iteration sorts a stack with n random integers; filling the stack is
+ * not timed. The memory budget of sort_stack_external is read (in bytes) from
+ * the SORT_STACK_MEMORY environment variable (default: 256 MiB), e.g.
+ *
+ *     SORT_STACK_MEMORY=16777216 make bench BENCHFLAGS=--filter=external
+ */
+
+template<typename Function>
+void bench_sort_stack(benchmark::state& state, Function sort)
+{
+    std::mt19937 generator(state.size());
+    size_t runs = 0;
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        std::stack<int> A;
+        for (size_t i = 0; i < state.size(); ++i)
+        {
+            A.push(generator());
+        }
+        state.resume_timing();
+
+        runs = sort(A);
+
+        state.pause_timing();
+        A = std::stack<int>();
+        state.resume_timing();
+    }
+
+    state.set_items_processed(state.size());
+    state.set_bytes_processed(state.size() * sizeof(int));
+    state.set_counter("spilled_runs", runs);
+}
+
+void bench_sort_stack_insertion(benchmark::state& state)
+{
+    bench_sort_stack(state, [](std::stack<int>& A) {
+        sort_stack(A);
+        return 0;
+    });
+}
+
+void bench_sort_stack_external(benchmark::state& state)
+{
+    const char* memory = std::getenv("SORT_STACK_MEMORY");
+    const size_t budget = memory ? std::strtoull(memory, nullptr, 10)
+                                 : 256 << 20;
+
+    bench_sort_stack(state, [=](std::stack<int>& A) {
+        return sort_stack_external(A, budget);
+    });
+}
+
+/* the insertion sort is quadratic, so it is only run on smaller stacks */
+REGISTER_BENCHMARK(bench_sort_stack_insertion, benchmark::range(16, 1 << 14));
+REGISTER_BENCHMARK(bench_sort_stack_external, benchmark::range(16, 1 << 30, 4));
+
+BENCHMARK_MAIN()
+
+#else
+
+/**
+ * @brief Sorts a copy of the values on a stack with sort_stack_external and
+ *        checks that the stack holds the same values, in ascending order.
+ */
+template<typename T, typename Stack = std::stack<T>>
+void check_sort_stack_external(const std::vector<T>& values,
+                               const size_t memory_budget)
+{
+    Stack A;
+    for (const T& value : values)
+    {
+        A.push(value);
+    }
+
+    const size_t runs = sort_stack_external(A, memory_budget);
+
+    /* the values are only spilled if they do not fit in the budget */
+    assert((runs == 0) == (values.size() <= std::max<size_t>(
+                                                 memory_budget / sizeof(T),
+                                                 16)));
+
+    std::vector<T> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    assert(A.size() == values.size());
+
+    for (const T& value : sorted)
+    {
+        assert(A.top() == value);
+        A.pop();
+    }
+}
+
 int main()
 {
     std::random_device device;
@@ -79,9 +224,103 @@ int main()
             }
         }
 
+        for (int i = 0; i < 100; ++i)
+        {
+            std::vector<int> values;
+            std::vector<double> doubles;
+
+            while (values.size() < n)
+            {
+                values.push_back(distribution(generator));
+                doubles.push_back(values.back() / 3.0);
+            }
+
+            /* budgets of 16 values (the minimum) to n values */
+            const size_t budget = (i % (n + 1)) * sizeof(int);
+
+            check_sort_stack_external(values, budget);
+            check_sort_stack_external<int, std::stack<int, std::vector<int>>>(
+                values, budget);
+            check_sort_stack_external(doubles, 2 * budget);
+        }
+
         std::cout << "passed random tests for stacks of size " << n
                   << std::endl;
     }
 
+    /* merge k sorted sequences with a loser tree */
+    for (size_t k = 1; k <= 40; ++k)
+    {
+        std::uniform_int_distribution<int> distribution(0, 100);
+
+        std::vector<std::vector<int>> sequences(k);
+        std::vector<int> values;
+
+        for (std::vector<int>& sequence : sequences)
+        {
+            sequence.resize(distribution(generator));
+            for (int& value : sequence)
+            {
+                value = distribution(generator);
+                values.push_back(value);
+            }
+            std::sort(sequence.begin(), sequence.end());
+        }
+
+        std::sort(values.begin(), values.end());
+
+        std::vector<size_t> positions(k, 0);
+
+        auto less = [&](const size_t i, const size_t j) {
+            if (positions[i] == sequences[i].size() ||
+                positions[j] == sequences[j].size())
+            {
+                return positions[i] < sequences[i].size();
+            }
+            return sequences[i][positions[i]] < sequences[j][positions[j]];
+        };
+
+        loser_tree<decltype(less)> tree(k, less);
+
+        for (const int value : values)
+        {
+            const size_t winner = tree.winner();
+
+            assert(positions[winner] < sequences[winner].size());
+            assert(sequences[winner][positions[winner]] == value);
+
+            ++positions[winner];
+            tree.replay();
+        }
+
+        assert(positions[tree.winner()] == sequences[tree.winner()].size());
+    }
+
+    std::cout << "passed loser tree tests" << std::endl;
+
+    /* larger stacks need several merge passes when the budget is small */
+    for (size_t n = 1000; n <= 1000000; n *= 10)
+    {
+        std::uniform_int_distribution<int> distribution(-1000000, 1000000);
+
+        std::vector<int> values;
+        while (values.size() < n)
+        {
+            values.push_back(distribution(generator));
+        }
+
+        /* smaller budgets would make too many merge passes */
+        for (size_t budget = std::max<size_t>(64, n / 64); budget <= (1 << 20);
+             budget *= 32)
+        {
+            check_sort_stack_external(values, budget);
+        }
+
+        std::cout << "passed external sorting tests for stacks of size " << n
+                  << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
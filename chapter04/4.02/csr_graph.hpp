@@ -0,0 +1,458 @@
+#ifndef __CSR_GRAPH_HPP__
+#define __CSR_GRAPH_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @brief A set of integers on [0,n) stored as a bitmap. */
+class bitmap
+{
+public:
+    explicit bitmap(const size_t n) : words_((n + 63) / 64, 0)
+    {
+        /* nothing needs to be done here */
+    }
+
+    bool test(const size_t i) const
+    {
+        return (words_[i / 64] >> (i % 64)) & 1;
+    }
+
+    void set(const size_t i)
+    {
+        words_[i / 64] |= uint64_t(1) << (i % 64);
+    }
+
+    /** @brief Removes all integers from the set. */
+    void clear()
+    {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+    void swap(bitmap& other)
+    {
+        words_.swap(other.words_);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief A static directed graph in compressed sparse row (CSR) format: the
+ *        successors of all nodes are stored in a single array, with those of
+ *        node u at positions [offsets[u], offsets[u+1]); the predecessors are
+ *        stored in the same way (for searches which go backwards).
+ * @note Nodes are stored as 32-bit integers, so a graph with m edges takes
+ *       about 8m bytes (plus 16 bytes per node), and the successors of a
+ *       node are contiguous in memory instead of scattered in list nodes.
+ */
+class csr_graph
+{
+public:
+    typedef uint32_t node;
+
+    /** @brief A range of nodes, usable in range-based for loops. */
+    struct node_range
+    {
+        const node* first;
+        const node* last;
+
+        const node* begin() const
+        {
+            return first;
+        }
+
+        const node* end() const
+        {
+            return last;
+        }
+
+        size_t size() const
+        {
+            return last - first;
+        }
+    };
+
+    /**
+     * @brief Builds the graph with n nodes and the given edges (u,v), each
+     *        one going from u to v.
+     * @note The successors (and predecessors) of each node keep the order of
+     *       the edge list, since they are placed with a counting sort.
+     * @note Complexity: O(n+m) in both time and space, where m is the number
+     *       of edges.
+     */
+    csr_graph(const size_t n, const std::vector<std::pair<node, node> >& edges)
+        : n_(n)
+    {
+        assert(n <= UINT32_MAX);
+
+        build(edges, false, out_offsets_, successors_);
+        build(edges, true, in_offsets_, predecessors_);
+    }
+
+    /** @brief Returns the number of nodes. */
+    size_t num_nodes() const
+    {
+        return n_;
+    }
+
+    /** @brief Returns the number of edges. */
+    size_t num_edges() const
+    {
+        return successors_.size();
+    }
+
+    /** @brief Returns the nodes to which u is connected. */
+    node_range successors(const size_t u) const
+    {
+        return {successors_.data() + out_offsets_[u],
+                successors_.data() + out_offsets_[u + 1]};
+    }
+
+    /** @brief Returns the nodes which are connected to u. */
+    node_range predecessors(const size_t u) const
+    {
+        return {predecessors_.data() + in_offsets_[u],
+                predecessors_.data() + in_offsets_[u + 1]};
+    }
+
+    size_t out_degree(const size_t u) const
+    {
+        return out_offsets_[u + 1] - out_offsets_[u];
+    }
+
+    size_t in_degree(const size_t u) const
+    {
+        return in_offsets_[u + 1] - in_offsets_[u];
+    }
+
+    /** @brief Returns the memory used by the graph (in bytes). */
+    size_t bytes_used() const
+    {
+        return (out_offsets_.size() + in_offsets_.size()) * sizeof(size_t) +
+               (successors_.size() + predecessors_.size()) * sizeof(node);
+    }
+
+private:
+    /**
+     * @brief Builds the offsets and targets of the successors (or, if reverse
+     *        is true, of the predecessors) of all nodes.
+     */
+    void build(const std::vector<std::pair<node, node> >& edges,
+               const bool reverse,
+               std::vector<size_t>& offsets,
+               std::vector<node>& targets) const
+    {
+        offsets.assign(n_ + 1, 0);
+        targets.resize(edges.size());
+
+        for (const std::pair<node, node>& edge : edges)
+        {
+            ++offsets[(reverse ? edge.second : edge.first) + 1];
+        }
+
+        for (size_t u = 0; u < n_; ++u)
+        {
+            offsets[u + 1] += offsets[u];
+        }
+
+        /* the next free position of each node (shifted back afterwards) */
+        for (const std::pair<node, node>& edge : edges)
+        {
+            const node u = reverse ? edge.second : edge.first;
+            targets[offsets[u]++] = reverse ? edge.first : edge.second;
+        }
+
+        for (size_t u = n_; u > 0; --u)
+        {
+            offsets[u] = offsets[u - 1];
+        }
+        offsets[0] = 0;
+    }
+
+    size_t n_;
+
+    std::vector<size_t> out_offsets_;
+    std::vector<node> successors_;
+
+    std::vector<size_t> in_offsets_;
+    std::vector<node> predecessors_;
+};
+
+/**
+ * @brief Returns true if a path from node s to node d exists, false otherwise
+ *        (using a top-down BFS with a bitmap of explored nodes).
+ * @note Complexity: O(m+n) in time, O(n) in space.
+ */
+inline bool has_path_top_down(const csr_graph& G,
+                              const size_t s,
+                              const size_t d)
+{
+    if (s == d)
+    {
+        return true;
+    }
+
+    bitmap explored(G.num_nodes());
+    std::vector<csr_graph::node> frontier = {csr_graph::node(s)};
+    std::vector<csr_graph::node> next_frontier;
+
+    explored.set(s);
+
+    while (frontier.empty() == false)
+    {
+        for (const csr_graph::node u : frontier)
+        {
+            for (const csr_graph::node v : G.successors(u))
+            {
+                if (explored.test(v) == false)
+                {
+                    if (v == d)
+                    {
+                        return true;
+                    }
+
+                    explored.set(v);
+                    next_frontier.push_back(v);
+                }
+            }
+        }
+
+        frontier.swap(next_frontier);
+        next_frontier.clear();
+    }
+
+    return false;
+}
+
+/**
+ * @brief Returns true if a path from node s to node d exists, false otherwise
+ *        (using a direction-optimizing BFS).
+ * @note A top-down step scans the edges leaving the frontier, while a
+ *       bottom-up step scans, for every unexplored node, its incoming edges
+ *       until one comes from the frontier. Once the frontier is large, most
+ *       unexplored nodes have a predecessor on it, so bottom-up steps examine
+ *       far fewer edges. As proposed by Beamer et al., the search switches to
+ *       bottom-up when the edges leaving the frontier outnumber 1/alpha of the
+ *       edges leaving unexplored nodes, and back to top-down when the frontier
+ *       has fewer than n/beta nodes.
+ * @note Complexity: O(m+n*h) in time, O(n) in space, where h is the number of
+ *       BFS levels (each bottom-up step goes over all nodes).
+ */
+inline bool has_path_direction_optimizing(const csr_graph& G,
+                                          const size_t s,
+                                          const size_t d,
+                                          const size_t alpha = 14,
+                                          const size_t beta = 24)
+{
+    if (s == d)
+    {
+        return true;
+    }
+
+    const size_t n = G.num_nodes();
+
+    bitmap explored(n);
+    std::vector<csr_graph::node> frontier = {csr_graph::node(s)};
+    std::vector<csr_graph::node> next_frontier;
+
+    /* the frontier as a bitmap, used by bottom-up steps */
+    bitmap in_frontier(n);
+    bitmap in_next_frontier(n);
+
+    explored.set(s);
+
+    /* edges leaving the frontier, and edges leaving unexplored nodes */
+    size_t frontier_edges = G.out_degree(s);
+    size_t unexplored_edges = G.num_edges() - frontier_edges;
+
+    while (frontier.empty() == false)
+    {
+        size_t next_frontier_edges = 0;
+
+        if (frontier_edges * alpha > unexplored_edges)
+        {
+            in_frontier.clear();
+            for (const csr_graph::node u : frontier)
+            {
+                in_frontier.set(u);
+            }
+
+            /* bottom-up steps, while the frontier stays large */
+            do
+            {
+                size_t frontier_size = 0;
+                in_next_frontier.clear();
+
+                for (size_t v = 0; v < n; ++v)
+                {
+                    if (explored.test(v))
+                    {
+                        continue;
+                    }
+
+                    for (const csr_graph::node u : G.predecessors(v))
+                    {
+                        if (in_frontier.test(u))
+                        {
+                            if (v == d)
+                            {
+                                return true;
+                            }
+
+                            explored.set(v);
+                            in_next_frontier.set(v);
+                            ++frontier_size;
+                            break;
+                        }
+                    }
+                }
+
+                in_frontier.swap(in_next_frontier);
+
+                if (frontier_size == 0)
+                {
+                    return false;
+                }
+
+                if (frontier_size * beta < n)
+                {
+                    break;
+                }
+            } while (true);
+
+            /* back to top-down steps */
+            frontier.clear();
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (in_frontier.test(v))
+                {
+                    frontier.push_back(v);
+                }
+            }
+
+            frontier_edges = 0;
+            unexplored_edges = 0;
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (in_frontier.test(v))
+                {
+                    frontier_edges += G.out_degree(v);
+                }
+                else if (explored.test(v) == false)
+                {
+                    unexplored_edges += G.out_degree(v);
+                }
+            }
+
+            continue;
+        }
+
+        for (const csr_graph::node u : frontier)
+        {
+            for (const csr_graph::node v : G.successors(u))
+            {
+                if (explored.test(v) == false)
+                {
+                    if (v == d)
+                    {
+                        return true;
+                    }
+
+                    explored.set(v);
+                    next_frontier.push_back(v);
+                    next_frontier_edges += G.out_degree(v);
+                }
+            }
+        }
+
+        frontier.swap(next_frontier);
+        next_frontier.clear();
+
+        frontier_edges = next_frontier_edges;
+        unexplored_edges -= next_frontier_edges;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Returns true if a path from node s to node d exists, false otherwise
+ *        (using a bidirectional BFS).
+ * @note A forward search from s (over successors) and a backward search from
+ *       d (over predecessors) take turns, always expanding the frontier with
+ *       fewer edges to scan, until a node is reached by both. On graphs where
+ *       the number of nodes within distance k grows quickly with k, each
+ *       search only needs to go half as deep, which visits far fewer nodes.
+ * @note Complexity: O(m+n) in time, O(n) in space.
+ */
+inline bool has_path_bidirectional(const csr_graph& G,
+                                   const size_t s,
+                                   const size_t d)
+{
+    if (s == d)
+    {
+        return true;
+    }
+
+    const size_t n = G.num_nodes();
+
+    bitmap forward_explored(n);
+    bitmap backward_explored(n);
+
+    std::vector<csr_graph::node> forward = {csr_graph::node(s)};
+    std::vector<csr_graph::node> backward = {csr_graph::node(d)};
+    std::vector<csr_graph::node> next;
+
+    forward_explored.set(s);
+    backward_explored.set(d);
+
+    size_t forward_edges = G.out_degree(s);
+    size_t backward_edges = G.in_degree(d);
+
+    while (forward.empty() == false && backward.empty() == false)
+    {
+        const bool go_forward = forward_edges <= backward_edges;
+
+        std::vector<csr_graph::node>& frontier = go_forward ? forward
+                                                            : backward;
+        bitmap& explored = go_forward ? forward_explored : backward_explored;
+        const bitmap& other = go_forward ? backward_explored
+                                         : forward_explored;
+
+        size_t next_edges = 0;
+
+        for (const csr_graph::node u : frontier)
+        {
+            for (const csr_graph::node v :
+                 go_forward ? G.successors(u) : G.predecessors(u))
+            {
+                if (explored.test(v) == false)
+                {
+                    if (other.test(v))
+                    {
+                        return true;
+                    }
+
+                    explored.set(v);
+                    next.push_back(v);
+                    next_edges += go_forward ? G.out_degree(v)
+                                             : G.in_degree(v);
+                }
+            }
+        }
+
+        frontier.swap(next);
+        next.clear();
+
+        (go_forward ? forward_edges : backward_edges) = next_edges;
+    }
+
+    return false;
+}
+
+#endif /* __CSR_GRAPH_HPP__ */
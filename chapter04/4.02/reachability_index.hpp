@@ -0,0 +1,530 @@
+#ifndef __REACHABILITY_INDEX_HPP__
+#define __REACHABILITY_INDEX_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include "csr_graph.hpp"
+
+/**
+ * @brief An index of a static directed graph which answers reachability
+ *        queries (is there a path from s to d?) without a full traversal.
+ * @note The index is built in two steps:
+ *         1. the strongly connected components (SCCs) are found with Tarjan's
+ *            algorithm and contracted, which leaves a DAG (the condensation);
+ *            nodes in the same SCC reach each other, and since Tarjan's
+ *            algorithm completes the SCCs in reverse topological order, an
+ *            SCC can only reach SCCs with smaller indices;
+ *         2. each SCC gets k GRAIL interval labels: for each label, the DAG is
+ *            traversed by a DFS (in a random order), the post-order rank of
+ *            each SCC is recorded, and its label is [low, rank], where low is
+ *            the smallest rank reachable from it; if c reaches c', the label
+ *            of c' is contained in the label of c for every traversal.
+ * @note Two more filters come almost for free: the level of each SCC (the
+ *       length of the longest path from it), which must decrease along any
+ *       path, and the subtree of each SCC in the DFS trees of the labels (the
+ *       ranks in [tree_low, rank]), which it certainly reaches.
+ * @note A query is answered in O(k) time when s and d are in the same SCC, when
+ *       the levels or labels rule out a path, or when a DFS tree contains one;
+ *       otherwise, a DFS from the SCC of s decides it, skipping every SCC whose
+ *       labels do not contain the labels of the SCC of d.
+ * @note The index is immutable once built: the scratch space of the DFS is
+ *       owned by the caller (one query_scratch per thread), so any number of
+ *       threads can query the same index concurrently.
+ */
+class reachability_index
+{
+public:
+    /**
+     * @brief The scratch space of the DFS of the queries, sized on its first
+     *        use; it can be reused across queries (and indexes).
+     */
+    class query_scratch
+    {
+    public:
+        /** @brief Returns the number of queries which needed a DFS so far. */
+        size_t dfs_queries() const
+        {
+            return dfs_queries_;
+        }
+
+    private:
+        friend class reachability_index;
+
+        /* visited_[c] == stamp_ marks the SCCs visited by the current query */
+        std::vector<uint32_t> visited_;
+        std::vector<uint32_t> stack_;
+        uint32_t stamp_ = 0;
+        size_t dfs_queries_ = 0;
+    };
+
+    /**
+     * @brief Builds the index of a graph with a given number of labels.
+     * @note Complexity: O(k(n+m)) in time, O(kn+m) in space.
+     */
+    explicit reachability_index(const csr_graph& G,
+                                const size_t num_labels = 4,
+                                const uint32_t seed = 0)
+        : reachability_index(G, random_rotations(num_labels, seed), seed)
+    {
+        /* nothing needs to be done here */
+    }
+
+    /**
+     * @brief Builds the index of a graph with one label per rotation: in the
+     *        DFS of the i-th label, SCC c visits its successors starting from
+     *        the ((rotations[i] + c) mod degree)-th one.
+     * @note Complexity: O(k(n+m)) in time, O(kn+m) in space.
+     */
+    reachability_index(const csr_graph& G,
+                       const std::vector<uint32_t>& rotations,
+                       const uint32_t seed = 0)
+        : num_labels_(rotations.size())
+    {
+        find_components(G);
+        build_condensation(G);
+        build_labels(rotations, seed);
+    }
+
+    /**
+     * @brief Returns true if a path from node s to node d exists, false
+     *        otherwise.
+     * @param scratch The scratch space of the DFS (which must not be used by
+     *        another thread during the query).
+     * @note Complexity: O(k) in time for queries answered by the labels,
+     *       O(k(n+m)) in time (in the worst case) for those which need a DFS,
+     *       O(n) in space (in the scratch space).
+     */
+    bool has_path(const size_t s,
+                  const size_t d,
+                  query_scratch& scratch) const
+    {
+        const uint32_t source = component_[s];
+        const uint32_t target = component_[d];
+
+        if (source == target)
+        {
+            return true;
+        }
+
+        if (levels_[source] <= levels_[target] ||
+            contains(source, target) == false)
+        {
+            return false;
+        }
+
+        if (tree_contains(source, target))
+        {
+            return true;
+        }
+
+        ++scratch.dfs_queries_;
+
+        std::vector<uint32_t>& visited = scratch.visited_;
+        std::vector<uint32_t>& stack = scratch.stack_;
+
+        if (visited.size() != num_components())
+        {
+            visited.assign(num_components(), 0);
+            scratch.stamp_ = 0;
+        }
+
+        if (++scratch.stamp_ == 0)
+        {
+            std::fill(visited.begin(), visited.end(), 0);
+            scratch.stamp_ = 1;
+        }
+
+        const uint32_t stamp = scratch.stamp_;
+
+        stack.assign(1, source);
+        visited[source] = stamp;
+
+        while (stack.empty() == false)
+        {
+            const uint32_t c = stack.back();
+            stack.pop_back();
+
+            for (size_t i = offsets_[c]; i < offsets_[c + 1]; ++i)
+            {
+                const uint32_t next = successors_[i];
+
+                if (next == target)
+                {
+                    return true;
+                }
+
+                if (visited[next] == stamp ||
+                    levels_[next] <= levels_[target])
+                {
+                    continue;
+                }
+
+                if (tree_contains(next, target))
+                {
+                    return true;
+                }
+
+                /* SCCs which cannot reach the target are pruned */
+                if (contains(next, target))
+                {
+                    visited[next] = stamp;
+                    stack.push_back(next);
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /** @brief Returns the number of strongly connected components. */
+    size_t num_components() const
+    {
+        return offsets_.size() - 1;
+    }
+
+    /** @brief Returns the strongly connected component of node u. */
+    size_t component(const size_t u) const
+    {
+        return component_[u];
+    }
+
+    /** @brief Returns the memory used by the index (in bytes). */
+    size_t bytes_used() const
+    {
+        return component_.size() * sizeof(uint32_t) +
+               offsets_.size() * sizeof(size_t) +
+               successors_.size() * sizeof(uint32_t) +
+               levels_.size() * sizeof(uint32_t) +
+               labels_.size() * sizeof(label);
+    }
+
+private:
+    /** @brief Returns k random rotations of the successor order. */
+    static std::vector<uint32_t> random_rotations(const size_t k,
+                                                  const uint32_t seed)
+    {
+        std::mt19937 generator(~seed);
+        std::vector<uint32_t> rotations(k);
+
+        for (uint32_t& rotation : rotations)
+        {
+            rotation = generator();
+        }
+
+        return rotations;
+    }
+
+    /**
+     * @brief A GRAIL label: the interval [low, rank] of post-order ranks, and
+     *        the ranks [tree_low, rank] of the subtree in the DFS tree.
+     */
+    struct label
+    {
+        uint32_t low;
+        uint32_t tree_low;
+        uint32_t rank;
+    };
+
+    /**
+     * @brief Returns true if all labels of SCC a contain those of SCC b
+     *        (which is necessary for a to reach b).
+     */
+    bool contains(const uint32_t a, const uint32_t b) const
+    {
+        const label* x = labels_.data() + a * num_labels_;
+        const label* y = labels_.data() + b * num_labels_;
+
+        for (size_t i = 0; i < num_labels_; ++i)
+        {
+            if (y[i].low < x[i].low || y[i].rank > x[i].rank)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns true if SCC b is in the subtree of SCC a in some DFS
+     *        tree (which is sufficient for a to reach b).
+     */
+    bool tree_contains(const uint32_t a, const uint32_t b) const
+    {
+        const label* x = labels_.data() + a * num_labels_;
+        const label* y = labels_.data() + b * num_labels_;
+
+        for (size_t i = 0; i < num_labels_; ++i)
+        {
+            if (x[i].tree_low <= y[i].rank && y[i].rank <= x[i].rank)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Finds the SCCs of the graph with Tarjan's algorithm (using an
+     *        explicit stack, since the DFS can be as deep as the graph is
+     *        large), numbering them in the order in which they complete.
+     */
+    void find_components(const csr_graph& G)
+    {
+        const size_t n = G.num_nodes();
+        const uint32_t unvisited = UINT32_MAX;
+
+        component_.assign(n, unvisited);
+
+        std::vector<uint32_t> index(n, unvisited);
+        std::vector<uint32_t> low(n);
+
+        /* the nodes visited but not yet assigned to an SCC */
+        std::vector<uint32_t> scc_stack;
+
+        /* the DFS path: each node and the position of its next successor */
+        std::vector<std::pair<uint32_t, uint32_t> > path;
+
+        uint32_t next_index = 0;
+        uint32_t next_component = 0;
+
+        for (size_t root = 0; root < n; ++root)
+        {
+            if (index[root] != unvisited)
+            {
+                continue;
+            }
+
+            path.emplace_back(root, 0);
+            index[root] = low[root] = next_index++;
+            scc_stack.push_back(root);
+
+            while (path.empty() == false)
+            {
+                const uint32_t u = path.back().first;
+                const csr_graph::node_range successors = G.successors(u);
+
+                if (path.back().second < successors.size())
+                {
+                    const uint32_t v = successors.first[path.back().second++];
+
+                    if (index[v] == unvisited)
+                    {
+                        path.emplace_back(v, 0);
+                        index[v] = low[v] = next_index++;
+                        scc_stack.push_back(v);
+                    }
+                    else if (component_[v] == unvisited)
+                    {
+                        /* v is on the SCC stack */
+                        low[u] = std::min(low[u], index[v]);
+                    }
+
+                    continue;
+                }
+
+                /* all successors of u were explored */
+                path.pop_back();
+
+                if (path.empty() == false)
+                {
+                    const uint32_t parent = path.back().first;
+                    low[parent] = std::min(low[parent], low[u]);
+                }
+
+                if (low[u] == index[u])
+                {
+                    uint32_t v;
+                    do
+                    {
+                        v = scc_stack.back();
+                        scc_stack.pop_back();
+                        component_[v] = next_component;
+                    } while (v != u);
+
+                    ++next_component;
+                }
+            }
+        }
+
+        offsets_.assign(next_component + 1, 0);
+    }
+
+    /**
+     * @brief Builds the DAG of SCCs (without duplicate edges) in CSR form, and
+     *        computes the level of each SCC.
+     */
+    void build_condensation(const csr_graph& G)
+    {
+        const size_t n = G.num_nodes();
+        const size_t num_components = offsets_.size() - 1;
+
+        /* the nodes of each SCC, grouped with a counting sort */
+        std::vector<size_t> first(num_components + 1, 0);
+        std::vector<uint32_t> nodes(n);
+
+        for (size_t u = 0; u < n; ++u)
+        {
+            ++first[component_[u] + 1];
+        }
+
+        for (size_t c = 0; c < num_components; ++c)
+        {
+            first[c + 1] += first[c];
+        }
+
+        for (size_t u = 0; u < n; ++u)
+        {
+            nodes[first[component_[u]]++] = u;
+        }
+
+        for (size_t c = num_components; c > 0; --c)
+        {
+            first[c] = first[c - 1];
+        }
+        first[0] = 0;
+
+        /* last[c'] == c + 1 if the edge c -> c' was already added */
+        std::vector<uint32_t> last(num_components, 0);
+
+        levels_.assign(num_components, 0);
+
+        for (size_t c = 0; c < num_components; ++c)
+        {
+            for (size_t i = first[c]; i < first[c + 1]; ++i)
+            {
+                for (const csr_graph::node v : G.successors(nodes[i]))
+                {
+                    const uint32_t next = component_[v];
+
+                    if (next != c && last[next] != c + 1)
+                    {
+                        last[next] = c + 1;
+                        successors_.push_back(next);
+
+                        /* next < c, so its level is already known */
+                        levels_[c] = std::max(levels_[c], levels_[next] + 1);
+                    }
+                }
+            }
+
+            offsets_[c + 1] = successors_.size();
+        }
+
+        successors_.shrink_to_fit();
+    }
+
+    /**
+     * @brief Computes the GRAIL labels of all SCCs, with one randomized DFS
+     *        of the condensation per label.
+     */
+    void build_labels(const std::vector<uint32_t>& rotations,
+                      const uint32_t seed)
+    {
+        const size_t num_components = offsets_.size() - 1;
+
+        labels_.resize(num_components * num_labels_);
+
+        std::mt19937 generator(seed);
+
+        /* the DFS roots, visited in a different random order each time */
+        std::vector<uint32_t> roots(num_components);
+        for (size_t c = 0; c < num_components; ++c)
+        {
+            roots[c] = c;
+        }
+
+        std::vector<bool> visited;
+
+        /* the DFS path: each SCC and the number of its visited successors */
+        std::vector<std::pair<uint32_t, uint32_t> > path;
+
+        for (size_t l = 0; l < num_labels_; ++l)
+        {
+            std::shuffle(roots.begin(), roots.end(), generator);
+            visited.assign(num_components, false);
+
+            /* the successors of each SCC are visited from a rotated offset */
+            const size_t rotation = rotations[l];
+            uint32_t next_rank = 0;
+
+            for (const uint32_t root : roots)
+            {
+                if (visited[root])
+                {
+                    continue;
+                }
+
+                visited[root] = true;
+                path.emplace_back(root, 0);
+                labels_[root * num_labels_ + l].low = UINT32_MAX;
+                labels_[root * num_labels_ + l].tree_low = next_rank;
+
+                while (path.empty() == false)
+                {
+                    const uint32_t c = path.back().first;
+                    const size_t degree = offsets_[c + 1] - offsets_[c];
+                    label& current = labels_[c * num_labels_ + l];
+
+                    if (path.back().second < degree)
+                    {
+                        /* computed modulo degree so it cannot overflow */
+                        const size_t i = (path.back().second++ +
+                                          (rotation + c) % degree) % degree;
+                        const uint32_t next = successors_[offsets_[c] + i];
+
+                        if (visited[next] == false)
+                        {
+                            visited[next] = true;
+                            path.emplace_back(next, 0);
+                            labels_[next * num_labels_ + l].low = UINT32_MAX;
+                            labels_[next * num_labels_ + l].tree_low =
+                                next_rank;
+                        }
+                        else
+                        {
+                            /* next is done, since the graph is a DAG */
+                            const label& done = labels_[next * num_labels_ + l];
+                            current.low = std::min(current.low, done.low);
+                        }
+
+                        continue;
+                    }
+
+                    current.rank = next_rank++;
+                    current.low = std::min(current.low, current.rank);
+
+                    path.pop_back();
+
+                    if (path.empty() == false)
+                    {
+                        label& parent =
+                            labels_[path.back().first * num_labels_ + l];
+                        parent.low = std::min(parent.low, current.low);
+                    }
+                }
+            }
+        }
+    }
+
+    size_t num_labels_;
+
+    /* the SCC of each node */
+    std::vector<uint32_t> component_;
+
+    /* the condensation: the successors of SCC c are at [offsets_[c], ...) */
+    std::vector<size_t> offsets_;
+    std::vector<uint32_t> successors_;
+
+    /* the length of the longest path from each SCC */
+    std::vector<uint32_t> levels_;
+
+    /* the labels of SCC c are at [c * num_labels_, (c + 1) * num_labels_) */
+    std::vector<label> labels_;
+};
+
+#endif /* __REACHABILITY_INDEX_HPP__ */
@@ -10,7 +10,14 @@
 #include <queue>
 #include <random>
 #include <unordered_set>
+#include <utility>
 #include <vector>
+#include "csr_graph.hpp"
+#include "reachability_index.hpp"
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /** @brief A directed graph represented by its adjacency list. */
 class directed_graph
@@ -158,8 +165,332 @@ directed_graph random_graph(const size_t n, size_t m)
     return G;
 }
 
+/**
+ * @brief Converts a graph to the CSR format (keeping the order of the
+ *        adjacency lists).
+ * @note Complexity: O(n+m) in both time and space.
+ */
+csr_graph to_csr_graph(const directed_graph& G, const size_t n)
+{
+    std::vector<std::pair<csr_graph::node, csr_graph::node> > edges;
+
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (const size_t v : G.adjacency_list(u))
+        {
+            edges.emplace_back(u, v);
+        }
+    }
+
+    return csr_graph(n, edges);
+}
+
+#ifdef BENCHMARK
+
+/*
+ * The graphs have n nodes and 4n random edges; each iteration answers 16
+ * queries between random pairs of nodes. The recursion depth of has_path_dfs
+ * grows with n, so the graphs are kept small enough for the default stack.
+ */
+
+template<typename Function>
+void bench_has_path(benchmark::state& state, Function has_path)
+{
+    const size_t n = state.size();
+    const size_t num_queries = 16;
+
+    directed_graph G = random_graph(n, 4 * n);
+
+    std::mt19937 generator(n);
+    std::uniform_int_distribution<size_t> distribution(0, n - 1);
+
+    std::vector<std::pair<size_t, size_t>> queries;
+    while (queries.size() < num_queries)
+    {
+        queries.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    while (state.keep_running())
+    {
+        for (const std::pair<size_t, size_t>& query : queries)
+        {
+            benchmark::do_not_optimize(has_path(G, query.first, query.second));
+        }
+    }
+
+    state.set_items_processed(num_queries);
+}
+
+void bench_has_path_bfs(benchmark::state& state)
+{
+    bench_has_path(state, has_path_bfs);
+}
+
+void bench_has_path_dfs(benchmark::state& state)
+{
+    bench_has_path(state, has_path_dfs);
+}
+
+/*
+ * Larger graphs have n nodes and 10n random edges (i.e., 10^8 edges for
+ * 10^7 nodes); each iteration answers 4 queries between random pairs of
+ * nodes, most of which are connected. The adjacency lists take 32 bytes per
+ * edge, so the list-based BFS only runs on graphs with up to 10^6 nodes.
+ */
+
+std::vector<std::pair<csr_graph::node, csr_graph::node> > random_edges(
+    const size_t n,
+    const size_t m)
+{
+    std::mt19937 generator(n);
+    std::uniform_int_distribution<csr_graph::node> distribution(0, n - 1);
+
+    std::vector<std::pair<csr_graph::node, csr_graph::node> > edges(m);
+
+    for (std::pair<csr_graph::node, csr_graph::node>& edge : edges)
+    {
+        edge.first = distribution(generator);
+        edge.second = distribution(generator);
+    }
+
+    return edges;
+}
+
+template<typename Graph, typename Function>
+void bench_has_path_sparse(benchmark::state& state,
+                           const Graph& G,
+                           Function has_path)
+{
+    const size_t n = state.size();
+    const size_t num_queries = 4;
+
+    std::mt19937 generator(n + 1);
+    std::uniform_int_distribution<size_t> distribution(0, n - 1);
+
+    std::vector<std::pair<size_t, size_t>> queries;
+    while (queries.size() < num_queries)
+    {
+        queries.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    while (state.keep_running())
+    {
+        for (const std::pair<size_t, size_t>& query : queries)
+        {
+            benchmark::do_not_optimize(has_path(G, query.first, query.second));
+        }
+    }
+
+    state.set_items_processed(num_queries);
+}
+
+void bench_has_path_bfs_lists(benchmark::state& state)
+{
+    const size_t n = state.size();
+    directed_graph G(n);
+
+    for (const auto& edge : random_edges(n, 10 * n))
+    {
+        G.create_edge(edge.first, edge.second);
+    }
+
+    bench_has_path_sparse(state, G, has_path_bfs);
+}
+
+template<typename Function>
+void bench_has_path_csr(benchmark::state& state, Function has_path)
+{
+    const size_t n = state.size();
+    csr_graph G(n, random_edges(n, 10 * n));
+
+    bench_has_path_sparse(state, G, has_path);
+}
+
+void bench_has_path_top_down(benchmark::state& state)
+{
+    bench_has_path_csr(state, [](const csr_graph& G, size_t s, size_t d) {
+        return has_path_top_down(G, s, d);
+    });
+}
+
+void bench_has_path_direction_optimizing(benchmark::state& state)
+{
+    bench_has_path_csr(state, [](const csr_graph& G, size_t s, size_t d) {
+        return has_path_direction_optimizing(G, s, d);
+    });
+}
+
+void bench_has_path_bidirectional(benchmark::state& state)
+{
+    bench_has_path_csr(state, [](const csr_graph& G, size_t s, size_t d) {
+        return has_path_bidirectional(G, s, d);
+    });
+}
+
+/* each iteration builds a CSR graph from n nodes and 10n edges */
+void bench_build_csr_graph(benchmark::state& state)
+{
+    const size_t n = state.size();
+    const auto edges = random_edges(n, 10 * n);
+
+    size_t bytes = 0;
+
+    while (state.keep_running())
+    {
+        csr_graph G(n, edges);
+        bytes = G.bytes_used();
+    }
+
+    state.set_items_processed(edges.size());
+    state.set_counter("bytes_per_edge", double(bytes) / edges.size());
+}
+
+/*
+ * The reachability index is built on graphs with n nodes and 4n edges which
+ * mostly go from lower to higher nodes, plus n/100 random edges which create
+ * some cycles, so the graphs have many SCCs and many unreachable pairs (on
+ * the random graphs above, nearly all nodes form a single SCC).
+ */
+
+std::vector<std::pair<csr_graph::node, csr_graph::node> > random_dag_edges(
+    const size_t n)
+{
+    std::mt19937 generator(n);
+    std::uniform_int_distribution<csr_graph::node> distribution(0, n - 1);
+
+    std::vector<std::pair<csr_graph::node, csr_graph::node> > edges(4 * n);
+
+    for (std::pair<csr_graph::node, csr_graph::node>& edge : edges)
+    {
+        edge.first = distribution(generator);
+        edge.second = distribution(generator);
+
+        if (edge.first > edge.second)
+        {
+            std::swap(edge.first, edge.second);
+        }
+    }
+
+    for (size_t i = 0; i < n / 100; ++i)
+    {
+        edges.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    return edges;
+}
+
+/* each iteration builds the index of a graph (n nodes, about 4n edges) */
+void bench_build_reachability_index(benchmark::state& state)
+{
+    const size_t n = state.size();
+    csr_graph G(n, random_dag_edges(n));
+
+    size_t bytes = 0;
+    size_t components = 0;
+
+    while (state.keep_running())
+    {
+        reachability_index index(G);
+        bytes = index.bytes_used();
+        components = index.num_components();
+    }
+
+    state.set_items_processed(n + G.num_edges());
+    state.set_counter("index_bytes_per_node", double(bytes) / n);
+    state.set_counter("components", components);
+}
+
+/*
+ * Each iteration answers 1024 queries between random pairs of nodes; the
+ * fraction of queries which needed a DFS and the share of reachable pairs
+ * are reported as counters.
+ */
+template<typename Function>
+void bench_reachability_queries(benchmark::state& state, Function has_path)
+{
+    const size_t n = state.size();
+    const size_t num_queries = 1024;
+
+    csr_graph G(n, random_dag_edges(n));
+    reachability_index index(G);
+    reachability_index::query_scratch scratch;
+
+    std::mt19937 generator(n + 1);
+    std::uniform_int_distribution<size_t> distribution(0, n - 1);
+
+    std::vector<std::pair<size_t, size_t>> queries;
+    while (queries.size() < num_queries)
+    {
+        queries.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    size_t reachable = 0;
+    for (const std::pair<size_t, size_t>& query : queries)
+    {
+        reachable += index.has_path(query.first, query.second, scratch);
+    }
+
+    const size_t dfs_queries = scratch.dfs_queries();
+
+    while (state.keep_running())
+    {
+        for (const std::pair<size_t, size_t>& query : queries)
+        {
+            benchmark::do_not_optimize(
+                has_path(G, index, scratch, query.first, query.second));
+        }
+    }
+
+    state.set_items_processed(num_queries);
+    state.set_counter("reachable", double(reachable) / num_queries);
+    state.set_counter("dfs_fraction", double(dfs_queries) / num_queries);
+}
+
+void bench_has_path_index(benchmark::state& state)
+{
+    bench_reachability_queries(state, [](const csr_graph&,
+                                         const reachability_index& index,
+                                         reachability_index::query_scratch&
+                                             scratch,
+                                         size_t s,
+                                         size_t d) {
+        return index.has_path(s, d, scratch);
+    });
+}
+
+void bench_has_path_index_bidirectional(benchmark::state& state)
+{
+    bench_reachability_queries(state, [](const csr_graph& G,
+                                         const reachability_index&,
+                                         reachability_index::query_scratch&,
+                                         size_t s,
+                                         size_t d) {
+        return has_path_bidirectional(G, s, d);
+    });
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 14, 4);
+const std::vector<size_t> large_sizes = benchmark::range(10, 10000000, 10);
+
+REGISTER_BENCHMARK(bench_has_path_bfs, sizes);
+REGISTER_BENCHMARK(bench_has_path_dfs, sizes);
+REGISTER_BENCHMARK(bench_has_path_bfs_lists, benchmark::range(10, 1000000, 10));
+REGISTER_BENCHMARK(bench_has_path_top_down, large_sizes);
+REGISTER_BENCHMARK(bench_has_path_direction_optimizing, large_sizes);
+REGISTER_BENCHMARK(bench_has_path_bidirectional, large_sizes);
+REGISTER_BENCHMARK(bench_build_csr_graph, large_sizes);
+REGISTER_BENCHMARK(bench_build_reachability_index, large_sizes);
+REGISTER_BENCHMARK(bench_has_path_index, large_sizes);
+REGISTER_BENCHMARK(bench_has_path_index_bidirectional, large_sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
+    std::mt19937 generator(std::random_device{}());
+
     for (size_t n = 0; n <= 20; ++n)
     {
         for (size_t m = 0; m <= n * n; ++m)
@@ -178,6 +509,36 @@ int main()
                 }
             }
 
+            /*
+             * the CSR searches and the reachability index are only checked
+             * on a sample of the edge counts (every fifth one and the last)
+             */
+            if (m % 5 == 0 || m == n * n)
+            {
+                csr_graph C = to_csr_graph(G, n);
+                reachability_index index(C, m % 4, m);
+                reachability_index::query_scratch scratch;
+
+                for (size_t u = 0; u < n; ++u)
+                {
+                    for (size_t v = 0; v < n; ++v)
+                    {
+                        const bool path = has_path_bfs(G, u, v);
+
+                        assert(path == has_path_top_down(C, u, v));
+                        assert(path == has_path_direction_optimizing(C, u, v));
+                        assert(path == has_path_bidirectional(C, u, v));
+                        assert(path == index.has_path(u, v, scratch));
+
+                        /* nodes in the same SCC reach each other */
+                        if (index.component(u) == index.component(v))
+                        {
+                            assert(path == true);
+                        }
+                    }
+                }
+            }
+
             /*
              * sanity check: for all edges u -> v, a path between
              * u and v must exist
@@ -196,5 +557,187 @@ int main()
                   << std::endl;
     }
 
+    /* direction-optimizing BFS with thresholds which force both steps */
+    const std::pair<size_t, size_t> thresholds[] = {
+        {14, 24}, {1, 1}, {1000000, 2}, {2, 1000000}};
+
+    for (size_t n = 1; n <= 3000; n = 2 * n + 1)
+    {
+        for (const size_t m : {n / 2, n, 2 * n, 10 * n})
+        {
+            directed_graph G = random_graph(n, m);
+            csr_graph C = to_csr_graph(G, n);
+
+            assert(C.num_nodes() == n);
+            assert(C.num_edges() == m);
+
+            /* the CSR graph has the same adjacency lists */
+            for (size_t u = 0; u < n; ++u)
+            {
+                assert(std::equal(G.adjacency_list(u).begin(),
+                                  G.adjacency_list(u).end(),
+                                  C.successors(u).begin()));
+                assert(C.successors(u).size() == G.adjacency_list(u).size());
+
+                for (const csr_graph::node v : C.predecessors(u))
+                {
+                    const auto& successors = C.successors(v);
+                    assert(std::find(successors.begin(), successors.end(),
+                                     u) != successors.end());
+                }
+            }
+
+            std::uniform_int_distribution<size_t> distribution(0, n - 1);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const size_t s = distribution(generator);
+                const size_t d = distribution(generator);
+                const bool path = has_path_bfs(G, s, d);
+
+                assert(has_path_top_down(C, s, d) == path);
+                assert(has_path_bidirectional(C, s, d) == path);
+
+                for (const std::pair<size_t, size_t>& t : thresholds)
+                {
+                    assert(has_path_direction_optimizing(
+                               C, s, d, t.first, t.second) == path);
+                }
+            }
+        }
+
+        std::cout << "passed CSR tests for graphs of size " << n << std::endl;
+    }
+
+    /*
+     * reachability index on graphs with many SCCs: edges mostly go from
+     * lower to higher nodes, and a few random edges create cycles
+     */
+    reachability_index::query_scratch shared_scratch;
+
+    for (size_t n = 1; n <= 3000; n = 2 * n + 1)
+    {
+        std::uniform_int_distribution<size_t> distribution(0, n - 1);
+
+        for (const size_t m : {n / 2, n, 2 * n, 4 * n})
+        {
+            directed_graph G(n);
+
+            for (size_t i = 0; i < m; ++i)
+            {
+                size_t u = distribution(generator);
+                size_t v = distribution(generator);
+
+                if (u > v && i % 16 != 0)
+                {
+                    std::swap(u, v);
+                }
+
+                G.create_edge(u, v);
+            }
+
+            const csr_graph C = to_csr_graph(G, n);
+
+            for (const size_t num_labels : {0, 1, 5})
+            {
+                reachability_index index(C, num_labels, generator());
+
+                assert(index.num_components() <= n);
+
+                for (int i = 0; i < 200; ++i)
+                {
+                    const size_t s = distribution(generator);
+                    const size_t d = distribution(generator);
+
+                    /* one scratch space is reused across all indexes */
+                    assert(index.has_path(s, d, shared_scratch) ==
+                           has_path_bfs(G, s, d));
+                }
+            }
+        }
+
+        std::cout << "passed reachability index tests for graphs of size "
+                  << n << std::endl;
+    }
+
+    /* a long path and a long cycle (deep searches must not recurse) */
+    {
+        const size_t n = 1000000;
+        std::vector<std::pair<csr_graph::node, csr_graph::node> > edges;
+
+        for (size_t u = 0; u + 1 < n; ++u)
+        {
+            edges.emplace_back(u, u + 1);
+        }
+
+        const reachability_index path(csr_graph(n, edges));
+        reachability_index::query_scratch scratch;
+
+        assert(path.num_components() == n);
+        assert(path.has_path(0, n - 1, scratch) == true);
+        assert(path.has_path(n - 1, 0, scratch) == false);
+        assert(path.has_path(n / 2, n / 2 + 1, scratch) == true);
+
+        edges.emplace_back(n - 1, 0);
+
+        const reachability_index cycle(csr_graph(n, edges));
+        reachability_index::query_scratch cycle_scratch;
+
+        assert(cycle.num_components() == 1);
+        assert(cycle.has_path(n - 1, 0, cycle_scratch) == true);
+        assert(cycle_scratch.dfs_queries() == 0);
+    }
+
+    std::cout << "passed reachability index tests for deep graphs"
+              << std::endl;
+
+    /*
+     * rotations near 2^32 must still visit every successor once (otherwise
+     * the labels are wrong and direct successors look unreachable)
+     */
+    {
+        const size_t n = 1001;
+        std::vector<std::pair<csr_graph::node, csr_graph::node> > edges;
+
+        for (size_t v = 1; v < n; ++v)
+        {
+            edges.emplace_back(0, v);
+        }
+
+        const csr_graph C(n, edges);
+        reachability_index::query_scratch scratch;
+
+        /*
+         * node 0 is the last SCC (n - 1) and has n - 1 successors, so its
+         * rotated offset wraps around 2^32 for deltas below n - 1; the deltas
+         * tested are those around multiples of the degree
+         */
+        const uint32_t degree = n - 1;
+
+        for (const uint32_t delta : {0u,
+                                     1u,
+                                     degree - 1,
+                                     degree,
+                                     degree + 1,
+                                     2 * degree - 1,
+                                     2 * degree,
+                                     2 * degree + 1})
+        {
+            const std::vector<uint32_t> rotations = {UINT32_MAX - delta};
+            const reachability_index star(C, rotations);
+
+            for (size_t v = 1; v < n; ++v)
+            {
+                assert(star.has_path(0, v, scratch) == true);
+                assert(star.has_path(v, 0, scratch) == false);
+            }
+        }
+    }
+
+    std::cout << "passed reachability index tests for large rotations"
+              << std::endl;
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -0,0 +1,705 @@
+#ifndef __B_TREE_HPP__
+#define __B_TREE_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief An ordered multiset stored in a B-tree: every node holds between
+ *        Degree-1 and 2*Degree-1 sorted keys (except the root, which may hold
+ *        fewer), every internal node with k keys has k+1 children, and all
+ *        leaves are on the same level, so the height is O(log n / log Degree)
+ *        regardless of the insertion order.
+ * @note With the default degree, a node holds up to 31 keys, so a search
+ *       reads a few contiguous arrays instead of following one pointer per
+ *       key as in a binary search tree.
+ * @note Like binary_search_tree, this class provides insert, size, height and
+ *       the lists of keys at each level of the tree (here, the keys of all
+ *       nodes on each level, from left to right).
+ */
+template<typename T, size_t Degree = 16>
+class b_tree
+{
+    static_assert(Degree >= 2, "B-tree nodes need at least two children");
+
+    static const size_t max_keys = 2 * Degree - 1;
+
+    /** @brief A node of the B-tree (leaves have no children). */
+    struct tree_node
+    {
+        size_t size = 0;
+        T keys[max_keys];
+    };
+
+    /** @brief An internal node of the B-tree. */
+    struct inner_node : tree_node
+    {
+        tree_node* children[max_keys + 1];
+    };
+
+public:
+    class const_iterator;
+
+    /**
+     * @brief Default constructor.
+     * @note Complexity: O(1) in both time and space.
+     */
+    b_tree()
+    {
+        /* nothing needs to be done here */
+    }
+
+    b_tree(const b_tree&) = delete;
+    b_tree& operator=(const b_tree&) = delete;
+
+    /**
+     * @brief Destructor.
+     * @note Complexity: O(n) in time, O(h) in space, where n is the number of
+     *       keys and h is the tree height.
+     */
+    ~b_tree()
+    {
+        destroy(root_, height_);
+    }
+
+    /**
+     * @brief Inserts a key into the tree (after the keys equal to it).
+     * @note Nodes which are full are split on the way down, so the key can
+     *       always be inserted into its leaf without going back up.
+     * @note Complexity: O(Degree * log n / log Degree) in time, O(1) in space
+     *       (amortized), where n is the number of keys.
+     */
+    void insert(const T& key)
+    {
+        if (root_ == nullptr)
+        {
+            root_ = new tree_node;
+            height_ = 1;
+        }
+
+        /* a full root is split, which is the only way the tree grows */
+        if (root_->size == max_keys)
+        {
+            inner_node* root = new inner_node;
+            root->children[0] = root_;
+            root_ = root;
+
+            split_child(root, 0, height_ == 1);
+            ++height_;
+        }
+
+        tree_node* current = root_;
+
+        for (size_t level = 1; level < height_; ++level)
+        {
+            inner_node* inner = static_cast<inner_node*>(current);
+            size_t i = child_index(inner, key);
+
+            if (inner->children[i]->size == max_keys)
+            {
+                split_child(inner, i, level + 1 == height_);
+
+                /* equal keys go after the median */
+                if (!(key < inner->keys[i]))
+                {
+                    ++i;
+                }
+            }
+
+            current = inner->children[i];
+        }
+
+        const size_t i = child_index(current, key);
+
+        std::move_backward(current->keys + i,
+                           current->keys + current->size,
+                           current->keys + current->size + 1);
+        current->keys[i] = key;
+        ++current->size;
+
+        ++num_elements_;
+    }
+
+    /**
+     * @brief Replaces the contents of the tree with the keys [first, last),
+     *        which must be sorted.
+     * @note The tree is built bottom-up with nodes as full as possible, which
+     *       takes fewer nodes than inserting the keys one at a time (as the
+     *       splits leave half-empty nodes behind).
+     * @note Complexity: O(n) in time, O(n) in space.
+     */
+    template<typename RandomIt>
+    void bulk_load(RandomIt first, RandomIt last)
+    {
+        assert(std::is_sorted(first, last));
+
+        destroy(root_, height_);
+
+        root_ = nullptr;
+        height_ = 0;
+        num_elements_ = last - first;
+
+        if (first == last)
+        {
+            return;
+        }
+
+        /* the smallest height at which full nodes can hold all keys */
+        size_t capacity = max_keys;
+        height_ = 1;
+
+        while (capacity < num_elements_)
+        {
+            capacity = capacity * (max_keys + 1) + max_keys;
+            ++height_;
+        }
+
+        root_ = build(first, num_elements_, height_, 2);
+    }
+
+    /**
+     * @brief Returns the number of elements stored on the tree.
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t size() const
+    {
+        return num_elements_;
+    }
+
+    /**
+     * @brief Returns the tree height (the number of levels of nodes).
+     * @note Complexity: O(1) in both time and space.
+     */
+    size_t height() const
+    {
+        return height_;
+    }
+
+    /**
+     * @brief Returns an iterator to the first key which is not smaller than
+     *        the given key (or end() if there is none).
+     * @note Complexity: O(log n) in time, O(h) in space.
+     */
+    const_iterator lower_bound(const T& key) const
+    {
+        return bound(key, [](const T& a, const T& b) { return a < b; });
+    }
+
+    /**
+     * @brief Returns an iterator to the first key which is larger than the
+     *        given key (or end() if there is none).
+     * @note Complexity: O(log n) in time, O(h) in space.
+     */
+    const_iterator upper_bound(const T& key) const
+    {
+        return bound(key, [](const T& a, const T& b) { return !(b < a); });
+    }
+
+    /**
+     * @brief Returns true if the tree contains the given key.
+     * @note Complexity: O(log n) in time, O(1) in space.
+     */
+    bool contains(const T& key) const
+    {
+        const tree_node* current = root_;
+
+        for (size_t level = 1; level <= height_; ++level)
+        {
+            const T* it =
+                std::lower_bound(current->keys, current->keys + current->size,
+                                 key);
+
+            if (it != current->keys + current->size && !(key < *it))
+            {
+                return true;
+            }
+
+            if (level < height_)
+            {
+                current = children(current)[it - current->keys];
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Calls f(key) for every key on [low, high), in order.
+     * @note Complexity: O(log n + m) in time, O(h) in space, where m is the
+     *       number of keys in the range.
+     */
+    template<typename Function>
+    void for_each_in_range(const T& low, const T& high, Function f) const
+    {
+        for (const_iterator it = lower_bound(low);
+             it != end() && *it < high;
+             ++it)
+        {
+            f(*it);
+        }
+    }
+
+    /** @brief Returns an iterator to the smallest key. */
+    const_iterator begin() const
+    {
+        const_iterator it = end();
+
+        if (root_ != nullptr && root_->size > 0)
+        {
+            it.descend_leftmost(root_, height_);
+        }
+
+        return it;
+    }
+
+    /**
+     * @brief Returns the iterator past the largest key (which can be
+     *        decremented to the largest key).
+     */
+    const_iterator end() const
+    {
+        const_iterator it;
+        it.root_ = root_;
+        it.height_ = height_;
+
+        return it;
+    }
+
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /** @brief Returns a reverse iterator to the largest key. */
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /** @brief Returns the reverse iterator past the smallest key. */
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief Returns a vector of lists which contain the keys of the nodes
+     *        at each level of the tree (using BFS).
+     * @note Complexity: O(n) in both time and space, where n is the number
+     *       of keys in the tree.
+     */
+    std::vector<std::list<T> > level_node_list_bfs() const
+    {
+        if (root_ == nullptr || root_->size == 0)
+        {
+            return {};
+        }
+
+        std::vector<std::list<T> > node_lists(height_);
+
+        /* the nodes of the current level, then those of the next one */
+        std::vector<const tree_node*> level = {root_};
+        std::vector<const tree_node*> next_level;
+
+        for (size_t depth = 0; depth < height_; ++depth)
+        {
+            for (const tree_node* current : level)
+            {
+                node_lists[depth].insert(node_lists[depth].end(),
+                                         current->keys,
+                                         current->keys + current->size);
+
+                if (depth + 1 < height_)
+                {
+                    next_level.insert(next_level.end(),
+                                      children(current),
+                                      children(current) + current->size + 1);
+                }
+            }
+
+            level.swap(next_level);
+            next_level.clear();
+        }
+
+        return node_lists;
+    }
+
+    /**
+     * @brief Returns a vector of lists which contain the keys of the nodes
+     *        at each level of the tree (using DFS).
+     * @note Complexity: O(n) in time, O(n) in space, where n is the number
+     *       of keys in the tree.
+     */
+    std::vector<std::list<T> > level_node_list_dfs() const
+    {
+        if (root_ == nullptr || root_->size == 0)
+        {
+            return {};
+        }
+
+        std::vector<std::list<T> > node_lists(height_);
+        level_node_list_dfs(root_, 0, node_lists);
+
+        return node_lists;
+    }
+
+    /**
+     * @brief A bidirectional iterator over the keys in ascending order,
+     *        which stores the path from the root to the current key.
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const T& operator*() const
+        {
+            return path_.back().first->keys[path_.back().second];
+        }
+
+        const T* operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator& operator++()
+        {
+            const tree_node* current = path_.back().first;
+            const size_t i = path_.back().second;
+
+            /* internal nodes continue with the leftmost key on the right */
+            if (path_.size() < height_)
+            {
+                ++path_.back().second;
+                descend_leftmost(children(current)[i + 1], height_);
+                return *this;
+            }
+
+            ++path_.back().second;
+
+            /* go up until a node has keys left */
+            while (path_.back().second == path_.back().first->size)
+            {
+                path_.pop_back();
+
+                if (path_.empty())
+                {
+                    break;
+                }
+            }
+
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        const_iterator& operator--()
+        {
+            /* end() goes back to the largest key */
+            if (path_.empty())
+            {
+                descend_rightmost(root_, height_);
+                return *this;
+            }
+
+            const tree_node* current = path_.back().first;
+            const size_t i = path_.back().second;
+
+            /* internal nodes continue with the rightmost key on the left */
+            if (path_.size() < height_)
+            {
+                descend_rightmost(children(current)[i], height_);
+                return *this;
+            }
+
+            if (i > 0)
+            {
+                --path_.back().second;
+                return *this;
+            }
+
+            /* go up until a node has keys on the left (begin() has none) */
+            do
+            {
+                path_.pop_back();
+                assert(path_.empty() == false);
+            } while (path_.back().second == 0);
+
+            --path_.back().second;
+
+            return *this;
+        }
+
+        const_iterator operator--(int)
+        {
+            const_iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            if (path_.empty() || other.path_.empty())
+            {
+                return path_.empty() && other.path_.empty();
+            }
+            return path_.back() == other.path_.back();
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class b_tree;
+
+        /** @brief Moves to the smallest key of the subtree rooted at node. */
+        void descend_leftmost(const tree_node* node, const size_t height)
+        {
+            height_ = height;
+
+            path_.emplace_back(node, 0);
+            while (path_.size() < height_)
+            {
+                node = children(node)[0];
+                path_.emplace_back(node, 0);
+            }
+        }
+
+        /** @brief Moves to the largest key of the subtree rooted at node. */
+        void descend_rightmost(const tree_node* node, const size_t height)
+        {
+            height_ = height;
+
+            path_.emplace_back(node, node->size);
+            while (path_.size() < height_)
+            {
+                node = children(node)[node->size];
+                path_.emplace_back(node, node->size);
+            }
+
+            --path_.back().second;
+        }
+
+        /* the nodes on the path and the key index (or child index) in each */
+        std::vector<std::pair<const tree_node*, size_t> > path_;
+        size_t height_ = 0;
+
+        /* the root of the tree, from which end() is decremented */
+        const tree_node* root_ = nullptr;
+    };
+
+private:
+    /** @brief Returns the children of an internal node. */
+    static tree_node* const* children(const tree_node* node)
+    {
+        return static_cast<const inner_node*>(node)->children;
+    }
+
+    /** @brief Returns the position of the first key larger than key. */
+    static size_t child_index(const tree_node* node, const T& key)
+    {
+        return std::upper_bound(node->keys, node->keys + node->size, key) -
+               node->keys;
+    }
+
+    /**
+     * @brief Finds the first key for which before(key, *it) is false, with
+     *        before being "<" (lower bound) or "<=" (upper bound).
+     */
+    template<typename Before>
+    const_iterator bound(const T& key, const Before& before) const
+    {
+        const_iterator it = end();
+
+        if (root_ == nullptr)
+        {
+            return it;
+        }
+
+        const tree_node* current = root_;
+
+        for (size_t level = 1; level <= height_; ++level)
+        {
+            size_t i = 0;
+            while (i < current->size && before(current->keys[i], key))
+            {
+                ++i;
+            }
+
+            it.path_.emplace_back(current, i);
+
+            if (level < height_)
+            {
+                current = children(current)[i];
+            }
+        }
+
+        /* if the bound is past the leaf, it is the first ancestor key left */
+        while (it.path_.empty() == false &&
+               it.path_.back().second == it.path_.back().first->size)
+        {
+            it.path_.pop_back();
+        }
+
+        return it;
+    }
+
+    /**
+     * @brief Splits the full i-th child of a node into two nodes, moving its
+     *        median key up into the node (which must not be full); leaf tells
+     *        whether the child is a leaf.
+     */
+    void split_child(inner_node* parent, const size_t i, const bool leaf)
+    {
+        tree_node* left = parent->children[i];
+        tree_node* right;
+
+        if (leaf)
+        {
+            right = new tree_node;
+        }
+        else
+        {
+            inner_node* inner_right = new inner_node;
+            std::copy(children(left) + Degree,
+                      children(left) + max_keys + 1,
+                      inner_right->children);
+            right = inner_right;
+        }
+
+        /* the left node keeps Degree-1 keys, the right one gets Degree-1 */
+        right->size = Degree - 1;
+        std::move(left->keys + Degree, left->keys + max_keys, right->keys);
+        left->size = Degree - 1;
+
+        std::move_backward(parent->keys + i,
+                           parent->keys + parent->size,
+                           parent->keys + parent->size + 1);
+        std::copy_backward(parent->children + i + 1,
+                           parent->children + parent->size + 1,
+                           parent->children + parent->size + 2);
+
+        parent->keys[i] = std::move(left->keys[Degree - 1]);
+        parent->children[i + 1] = right;
+        ++parent->size;
+    }
+
+    /**
+     * @brief Builds a subtree of a given height holding the count keys
+     *        starting at first, whose root has at least min_children children
+     *        (if it is an internal node).
+     */
+    template<typename RandomIt>
+    static tree_node* build(RandomIt first,
+                            const size_t count,
+                            const size_t height,
+                            const size_t min_children)
+    {
+        if (height == 1)
+        {
+            tree_node* leaf = new tree_node;
+            std::copy(first, first + count, leaf->keys);
+            leaf->size = count;
+            return leaf;
+        }
+
+        inner_node* node = new inner_node;
+
+        /* the number of keys a full subtree of height - 1 holds */
+        size_t child_capacity = max_keys;
+        for (size_t h = 2; h < height; ++h)
+        {
+            child_capacity = child_capacity * (max_keys + 1) + max_keys;
+        }
+
+        /*
+         * use as few children as possible (so they are as full as possible),
+         * but enough for every node to hold at least Degree-1 keys
+         */
+        size_t children = (count + child_capacity + 1) / (child_capacity + 1);
+        children = std::max(children, min_children);
+
+        const size_t child_keys = count - (children - 1);
+
+        for (size_t c = 0; c < children; ++c)
+        {
+            /* the first child_keys % children children get one more key */
+            const size_t size =
+                child_keys / children + (c < child_keys % children ? 1 : 0);
+
+            node->children[c] = build(first, size, height - 1, Degree);
+            first += size;
+
+            if (c + 1 < children)
+            {
+                node->keys[c] = *first;
+                ++first;
+            }
+        }
+
+        node->size = children - 1;
+
+        return node;
+    }
+
+    static void destroy(tree_node* node, const size_t height)
+    {
+        if (node == nullptr)
+        {
+            return;
+        }
+
+        if (height == 1)
+        {
+            delete node;
+            return;
+        }
+
+        inner_node* inner = static_cast<inner_node*>(node);
+
+        for (size_t i = 0; i <= inner->size; ++i)
+        {
+            destroy(inner->children[i], height - 1);
+        }
+
+        delete inner;
+    }
+
+    void level_node_list_dfs(const tree_node* current,
+                             const size_t depth,
+                             std::vector<std::list<T> >& node_lists) const
+    {
+        node_lists[depth].insert(node_lists[depth].end(),
+                                 current->keys,
+                                 current->keys + current->size);
+
+        if (depth + 1 < height_)
+        {
+            for (size_t i = 0; i <= current->size; ++i)
+            {
+                level_node_list_dfs(
+                    children(current)[i], depth + 1, node_lists);
+            }
+        }
+    }
+
+    tree_node* root_ = nullptr;
+    size_t height_ = 0;
+    size_t num_elements_ = 0;
+};
+
+#endif /* __B_TREE_HPP__ */
@@ -1,11 +1,30 @@
 #ifndef __BINARY_SEARCH_TREE_HPP__
 #define __BINARY_SEARCH_TREE_HPP__
 
+#include <algorithm>
 #include <list>
 #include <queue>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
+/**
+ * @brief The keys at each level of a tree, stored contiguously: the keys at
+ *        level d are keys[offsets[d]], ..., keys[offsets[d+1]-1].
+ */
+template<typename T>
+struct level_order
+{
+    std::vector<size_t> offsets = {0};
+    std::vector<T> keys;
+
+    /** @brief Returns the number of levels. */
+    size_t levels() const
+    {
+        return offsets.size() - 1;
+    }
+};
+
 template<typename T>
 class binary_search_tree
 {
@@ -16,12 +35,6 @@ class binary_search_tree
 
         tree_node* left = nullptr;
         tree_node* right = nullptr;
-
-        ~tree_node()
-        {
-            delete left;
-            delete right;
-        }
     };
 
 public:
@@ -36,13 +49,36 @@ public:
 
     /**
      * @brief Destructor.
+     * @note The nodes are deleted without recursion, since degenerate trees
+     *       (e.g. built from sorted keys) are as deep as they are large.
      * @note Complexity: O(n) in both time and space, where n is the number
-     *       of tree nodes, because the recursion will not go deeper than n
-     *       levels.
+     *       of tree nodes.
      */
     ~binary_search_tree()
     {
-        delete root_;
+        std::vector<tree_node*> nodes;
+
+        if (root_ != nullptr)
+        {
+            nodes.push_back(root_);
+        }
+
+        while (nodes.empty() == false)
+        {
+            tree_node* current = nodes.back();
+            nodes.pop_back();
+
+            if (current->left != nullptr)
+            {
+                nodes.push_back(current->left);
+            }
+            if (current->right != nullptr)
+            {
+                nodes.push_back(current->right);
+            }
+
+            delete current;
+        }
     }
 
     /**
@@ -192,7 +228,177 @@ public:
         return level_node_list_dfs(root_);
     }
 
+    /**
+     * @brief Returns the keys of the nodes at each level of the tree (using a
+     *        BFS), as offsets into a single buffer of keys.
+     * @param num_threads The number of threads used to expand wide levels.
+     * @note The threads write the keys of each level straight into the
+     *       buffer, at the offset of the level.
+     * @note Complexity: O(n/p + h) in time (plus O(n) to allocate and
+     *       initialize the buffer of keys), O(n) in space, where n is the
+     *       number of nodes, h is the tree height and p is the number of
+     *       threads.
+     */
+    level_order<T> level_node_list_flat(
+        const size_t num_threads = std::thread::hardware_concurrency()) const
+    {
+        level_order<T> levels;
+        levels.keys.resize(num_elements_);
+
+        expand_levels(
+            [&](const size_t) {
+                return levels.keys.data() + levels.offsets.back();
+            },
+            [&](const size_t, const T*, const size_t count) {
+                levels.offsets.push_back(levels.offsets.back() + count);
+            },
+            num_threads);
+
+        return levels;
+    }
+
+    /**
+     * @brief Calls f(depth, keys, count) for each level of the tree, from the
+     *        root down, as soon as the level is complete (the keys pointer is
+     *        only valid during the call).
+     * @param num_threads The number of threads used to expand wide levels.
+     * @return The largest number of threads which expanded a level.
+     * @note Only two levels are stored at any time, so this needs much less
+     *       memory than building the lists of all levels.
+     * @note Each level is expanded into the next one in two passes: the
+     *       threads first count the children of their share of the level,
+     *       then write them (and the keys of the level) at the offsets given
+     *       by the prefix sums of the counts, so the next level is built in
+     *       order without locks. Narrow levels are expanded by the calling
+     *       thread alone, since starting threads would take longer.
+     * @note Complexity: O(n/p + h) in time, O(w) in space, where w is the
+     *       largest number of nodes on a level.
+     */
+    template<typename Function>
+    size_t for_each_level(
+        Function f,
+        const size_t num_threads = std::thread::hardware_concurrency()) const
+    {
+        std::vector<T> keys;
+
+        return expand_levels(
+            [&](const size_t n) {
+                keys.resize(n);
+                return keys.data();
+            },
+            f,
+            num_threads);
+    }
+
 private:
+    /* levels narrower than this are expanded by a single thread */
+    static const size_t min_parallel_width = 1 << 14;
+
+    /**
+     * @brief Expands the tree level by level as for_each_level does, writing
+     *        the keys of each level (of n nodes) into the buffer returned by
+     *        keys_at(n), then calling f(depth, keys, n).
+     * @return The largest number of threads which expanded a level.
+     */
+    template<typename Buffer, typename Function>
+    size_t expand_levels(Buffer keys_at,
+                         Function f,
+                         const size_t num_threads) const
+    {
+        size_t max_threads = 0;
+
+        if (root_ == nullptr)
+        {
+            return max_threads;
+        }
+
+        std::vector<const tree_node*> level = {root_};
+        std::vector<const tree_node*> next_level;
+
+        for (size_t depth = 0; level.empty() == false; ++depth)
+        {
+            const size_t n = level.size();
+
+            /* each thread gets at least min_parallel_width nodes */
+            const size_t p = std::max<size_t>(
+                1, std::min(num_threads, n / min_parallel_width));
+
+            max_threads = std::max(max_threads, p);
+
+            /* children[c+1] is the number of children of the c-th share */
+            std::vector<size_t> children(p + 1, 0);
+
+            T* keys = keys_at(n);
+
+            parallel_for(p, [&](const size_t c) {
+                /*
+                 * counted locally: the counters of all threads share a cache
+                 * line, and the stores to keys could alias them
+                 */
+                size_t count = 0;
+
+                for (size_t i = n * c / p; i < n * (c + 1) / p; ++i)
+                {
+                    keys[i] = level[i]->key;
+                    count += (level[i]->left != nullptr) +
+                             (level[i]->right != nullptr);
+                }
+
+                children[c + 1] = count;
+            });
+
+            for (size_t c = 0; c < p; ++c)
+            {
+                children[c + 1] += children[c];
+            }
+
+            next_level.resize(children[p]);
+
+            parallel_for(p, [&](const size_t c) {
+                size_t j = children[c];
+
+                for (size_t i = n * c / p; i < n * (c + 1) / p; ++i)
+                {
+                    if (level[i]->left != nullptr)
+                    {
+                        next_level[j++] = level[i]->left;
+                    }
+                    if (level[i]->right != nullptr)
+                    {
+                        next_level[j++] = level[i]->right;
+                    }
+                }
+            });
+
+            f(depth, static_cast<const T*>(keys), n);
+
+            level.swap(next_level);
+        }
+
+        return max_threads;
+    }
+
+    /**
+     * @brief Calls step(c) for every c on [0,p), each on its own thread (the
+     *        calling thread runs step(0)).
+     */
+    template<typename Function>
+    static void parallel_for(const size_t p, const Function& step)
+    {
+        std::vector<std::thread> threads;
+
+        for (size_t c = 1; c < p; ++c)
+        {
+            threads.emplace_back(step, c);
+        }
+        step(0);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
     size_t height(const tree_node* current) const
     {
         if (current == nullptr)
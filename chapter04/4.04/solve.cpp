@@ -8,9 +8,19 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <queue>
 #include <random>
+#include <set>
+#include <utility>
+#include "b_tree.hpp"
 #include "binary_search_tree.hpp"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Generates a random vector of length n and values in [0,n].
  * @note Complexity: O(n) in both time and space.
@@ -32,6 +42,384 @@ std::vector<size_t> random_vector(const size_t n)
     return values;
 }
 
+#ifdef BENCHMARK
+
+/* the trees are built by inserting n random keys (in random order) */
+
+template<typename Function>
+void bench_level_node_list(benchmark::state& state, Function level_node_list)
+{
+    binary_search_tree<size_t> tree;
+
+    for (const size_t x : random_vector(state.size()))
+    {
+        tree.insert(x);
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(level_node_list(tree));
+    }
+
+    state.set_items_processed(tree.size());
+    state.set_counter("levels", tree.height());
+}
+
+void bench_level_node_list_bfs(benchmark::state& state)
+{
+    bench_level_node_list(state, [](const binary_search_tree<size_t>& tree) {
+        return tree.level_node_list_bfs();
+    });
+}
+
+void bench_level_node_list_dfs(benchmark::state& state)
+{
+    bench_level_node_list(state, [](const binary_search_tree<size_t>& tree) {
+        return tree.level_node_list_dfs();
+    });
+}
+
+/*
+ * Each iteration inserts n keys (in random or ascending order) into an empty
+ * container; destroying the container is not timed.
+ */
+
+template<typename Container>
+void bench_insert(benchmark::state& state, const bool sorted)
+{
+    std::vector<size_t> keys = random_vector(state.size());
+
+    if (sorted)
+    {
+        std::sort(keys.begin(), keys.end());
+    }
+
+    while (state.keep_running())
+    {
+        std::unique_ptr<Container> container(new Container);
+
+        for (const size_t x : keys)
+        {
+            container->insert(x);
+        }
+
+        state.pause_timing();
+        container.reset();
+        state.resume_timing();
+    }
+
+    state.set_items_processed(keys.size());
+}
+
+void bench_insert_random_bst(benchmark::state& state)
+{
+    bench_insert<binary_search_tree<size_t>>(state, false);
+}
+
+void bench_insert_random_b_tree(benchmark::state& state)
+{
+    bench_insert<b_tree<size_t>>(state, false);
+}
+
+void bench_insert_random_multiset(benchmark::state& state)
+{
+    bench_insert<std::multiset<size_t>>(state, false);
+}
+
+void bench_insert_sorted_bst(benchmark::state& state)
+{
+    bench_insert<binary_search_tree<size_t>>(state, true);
+}
+
+void bench_insert_sorted_b_tree(benchmark::state& state)
+{
+    bench_insert<b_tree<size_t>>(state, true);
+}
+
+void bench_insert_sorted_multiset(benchmark::state& state)
+{
+    bench_insert<std::multiset<size_t>>(state, true);
+}
+
+void bench_bulk_load_b_tree(benchmark::state& state)
+{
+    std::vector<size_t> keys = random_vector(state.size());
+    std::sort(keys.begin(), keys.end());
+
+    while (state.keep_running())
+    {
+        std::unique_ptr<b_tree<size_t>> tree(new b_tree<size_t>);
+        tree->bulk_load(keys.begin(), keys.end());
+
+        state.pause_timing();
+        tree.reset();
+        state.resume_timing();
+    }
+
+    state.set_items_processed(keys.size());
+}
+
+/* each iteration looks up the lower bound of a random key */
+template<typename Container>
+void bench_lookup(benchmark::state& state, const Container& container)
+{
+    std::vector<size_t> queries = random_vector(1 << 16);
+    size_t i = 0;
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(
+            *container.lower_bound(queries[i++ % queries.size()] / 2));
+    }
+
+    state.set_items_processed(1);
+}
+
+void bench_lookup_b_tree(benchmark::state& state)
+{
+    std::vector<size_t> keys = random_vector(state.size());
+    b_tree<size_t> tree;
+
+    for (const size_t x : keys)
+    {
+        tree.insert(x);
+    }
+
+    bench_lookup(state, tree);
+}
+
+void bench_lookup_b_tree_bulk_loaded(benchmark::state& state)
+{
+    std::vector<size_t> keys = random_vector(state.size());
+    std::sort(keys.begin(), keys.end());
+
+    b_tree<size_t> tree;
+    tree.bulk_load(keys.begin(), keys.end());
+
+    bench_lookup(state, tree);
+}
+
+void bench_lookup_multiset(benchmark::state& state)
+{
+    std::vector<size_t> keys = random_vector(state.size());
+    std::multiset<size_t> set(keys.begin(), keys.end());
+
+    bench_lookup(state, set);
+}
+
+void bench_level_node_list_flat(benchmark::state& state)
+{
+    bench_level_node_list(state, [](const binary_search_tree<size_t>& tree) {
+        return tree.level_node_list_flat();
+    });
+}
+
+void bench_level_node_list_flat_1_thread(benchmark::state& state)
+{
+    bench_level_node_list(state, [](const binary_search_tree<size_t>& tree) {
+        return tree.level_node_list_flat(1);
+    });
+}
+
+/* the levels are only summed up, so no list of levels is built */
+void bench_for_each_level(benchmark::state& state)
+{
+    bench_level_node_list(state, [](const binary_search_tree<size_t>& tree) {
+        size_t sum = 0;
+        tree.for_each_level(
+            [&](const size_t, const size_t* keys, const size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    sum += keys[i];
+                }
+            });
+        return sum;
+    });
+}
+
+void bench_level_node_list_bfs_b_tree(benchmark::state& state)
+{
+    b_tree<size_t> tree;
+
+    for (const size_t x : random_vector(state.size()))
+    {
+        tree.insert(x);
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(tree.level_node_list_bfs());
+    }
+
+    state.set_items_processed(tree.size());
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 20, 4);
+const std::vector<size_t> large_sizes = benchmark::range(16, 1 << 24, 4);
+const std::vector<size_t> huge_sizes = benchmark::range(16, 1 << 27, 4);
+
+REGISTER_BENCHMARK(bench_level_node_list_bfs, sizes);
+REGISTER_BENCHMARK(bench_level_node_list_dfs, sizes);
+REGISTER_BENCHMARK(bench_level_node_list_bfs_b_tree, sizes);
+
+/* a tree with 2^27 nodes takes about 4 GiB of memory */
+REGISTER_BENCHMARK(bench_level_node_list_flat, huge_sizes);
+REGISTER_BENCHMARK(bench_level_node_list_flat_1_thread, huge_sizes);
+REGISTER_BENCHMARK(bench_for_each_level, huge_sizes);
+
+/* sorted keys make the binary search tree a list, with O(n) inserts */
+REGISTER_BENCHMARK(bench_insert_random_bst, large_sizes);
+REGISTER_BENCHMARK(bench_insert_random_b_tree, large_sizes);
+REGISTER_BENCHMARK(bench_insert_random_multiset, large_sizes);
+REGISTER_BENCHMARK(bench_insert_sorted_bst, benchmark::range(16, 1 << 14, 4));
+REGISTER_BENCHMARK(bench_insert_sorted_b_tree, large_sizes);
+REGISTER_BENCHMARK(bench_insert_sorted_multiset, large_sizes);
+REGISTER_BENCHMARK(bench_bulk_load_b_tree, large_sizes);
+REGISTER_BENCHMARK(bench_lookup_b_tree, large_sizes);
+REGISTER_BENCHMARK(bench_lookup_b_tree_bulk_loaded, large_sizes);
+REGISTER_BENCHMARK(bench_lookup_multiset, large_sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
+/**
+ * @brief Checks that the flat level lists and the levels visited by
+ *        for_each_level are the given level lists.
+ * @return The largest number of threads which expanded a level.
+ */
+size_t check_level_node_list_flat(
+    const binary_search_tree<size_t>& tree,
+    const std::vector<std::list<size_t> >& node_lists,
+    const size_t num_threads)
+{
+    level_order<size_t> levels = tree.level_node_list_flat(num_threads);
+
+    assert(levels.levels() == node_lists.size());
+    assert(levels.keys.size() == tree.size());
+
+    for (size_t depth = 0; depth < levels.levels(); ++depth)
+    {
+        assert(std::list<size_t>(levels.keys.begin() + levels.offsets[depth],
+                                 levels.keys.begin() +
+                                     levels.offsets[depth + 1]) ==
+               node_lists[depth]);
+    }
+
+    size_t next_depth = 0;
+
+    const size_t threads = tree.for_each_level(
+        [&](const size_t depth, const size_t* keys, const size_t count) {
+            assert(depth == next_depth++);
+            assert(std::list<size_t>(keys, keys + count) == node_lists[depth]);
+        },
+        num_threads);
+
+    assert(next_depth == node_lists.size());
+
+    return threads;
+}
+
+/**
+ * @brief Checks a B-tree holding the given keys: its level lists (using BFS
+ *        and DFS), its node sizes, its height and its iterators.
+ */
+template<size_t Degree>
+void check_b_tree(const b_tree<size_t, Degree>& tree, std::vector<size_t> keys)
+{
+    assert(tree.size() == keys.size());
+
+    std::vector<std::list<size_t> > lists_bfs = tree.level_node_list_bfs();
+    std::vector<std::list<size_t> > lists_dfs = tree.level_node_list_dfs();
+
+    assert(lists_bfs == lists_dfs);
+    assert(tree.height() == lists_bfs.size());
+
+    /*
+     * each level has one more node than the keys on the previous level, and
+     * every node except the root has between Degree-1 and 2*Degree-1 keys
+     */
+    size_t nodes = 1;
+    size_t min_nodes = 1;
+
+    for (size_t depth = 0; depth < lists_bfs.size(); ++depth)
+    {
+        const size_t level_keys = lists_bfs[depth].size();
+
+        assert(level_keys <= (2 * Degree - 1) * nodes);
+        assert(depth == 0 || level_keys >= (Degree - 1) * nodes);
+
+        nodes += level_keys;
+        if (depth > 0)
+        {
+            min_nodes *= Degree;
+        }
+        assert(depth + 1 == lists_bfs.size() || nodes >= 2 * min_nodes);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<size_t> bfs_keys;
+    for (const std::list<size_t>& level_keys : lists_bfs)
+    {
+        bfs_keys.insert(bfs_keys.end(), level_keys.begin(), level_keys.end());
+    }
+    std::sort(bfs_keys.begin(), bfs_keys.end());
+
+    assert(bfs_keys == keys);
+
+    /* the iterators visit the keys in ascending (or descending) order */
+    assert(std::vector<size_t>(tree.begin(), tree.end()) == keys);
+    assert(std::vector<size_t>(tree.rbegin(), tree.rend()) ==
+           std::vector<size_t>(keys.rbegin(), keys.rend()));
+
+    /* the bounds and ranges of all keys (and values between them) */
+    for (size_t x = 0; x <= 2 * keys.size() + 1; x += 1 + x % 3)
+    {
+        auto lower = std::lower_bound(keys.begin(), keys.end(), x / 2);
+        auto upper = std::upper_bound(keys.begin(), keys.end(), x);
+
+        auto tree_lower = tree.lower_bound(x / 2);
+        auto tree_upper = tree.upper_bound(x);
+
+        assert((lower == keys.end()) == (tree_lower == tree.end()));
+        assert((upper == keys.end()) == (tree_upper == tree.end()));
+
+        if (lower != keys.end())
+        {
+            assert(*tree_lower == *lower);
+        }
+        if (upper != keys.end())
+        {
+            assert(*tree_upper == *upper);
+        }
+
+        /* the keys before the bounds (e.g. for reverse range scans) */
+        if (lower != keys.begin())
+        {
+            assert(*std::prev(tree_lower) == *std::prev(lower));
+        }
+        if (upper != keys.begin())
+        {
+            assert(*std::prev(tree_upper) == *std::prev(upper));
+        }
+
+        /* short ranges, so the checks take O(n log n) time in total */
+        const size_t high = x / 2 + x % 5;
+
+        std::vector<size_t> range;
+        tree.for_each_in_range(
+            x / 2, high, [&](const size_t key) { range.push_back(key); });
+
+        assert(range ==
+               std::vector<size_t>(
+                   lower, std::lower_bound(keys.begin(), keys.end(), high)));
+
+        assert(tree.contains(x) ==
+               std::binary_search(keys.begin(), keys.end(), x));
+    }
+}
+
 int main()
 {
     for (size_t n = 0; n <= 50; ++n)
@@ -61,6 +449,10 @@ int main()
             assert(lists_bfs == lists_dfs);
             assert(tree.height() == lists_bfs.size());
 
+            /* levels this narrow are always expanded by a single thread */
+            assert(check_level_node_list_flat(tree, lists_bfs, 4) ==
+                   (n > 0 ? 1 : 0));
+
             /*
              * put all keys obtained at each level into a single
              * (flattened) vector, then make sure this vector contains
@@ -78,10 +470,124 @@ int main()
             std::sort(bfs_keys.begin(), bfs_keys.end());
 
             assert(bfs_keys == keys);
+
+            /* B-trees are only tested on some keys, since checks are slow */
+            if (i < 20)
+            {
+                b_tree<size_t, 2> tree_2;
+                b_tree<size_t> tree_16;
+
+                for (const size_t x : keys)
+                {
+                    tree_2.insert(x);
+                    tree_16.insert(x);
+                }
+
+                check_b_tree(tree_2, keys);
+                check_b_tree(tree_16, keys);
+
+                tree_2.bulk_load(keys.begin(), keys.end());
+                tree_16.bulk_load(keys.begin(), keys.end());
+
+                check_b_tree(tree_2, keys);
+                check_b_tree(tree_16, keys);
+            }
         }
 
         std::cout << "passed tests for trees of size " << n << std::endl;
     }
 
+    /*
+     * levels wide enough to be expanded by several threads: a complete tree
+     * with h levels (its keys are even, and inserted in level order, so its
+     * last level has 2^(h-1) nodes), plus a ragged level of random odd keys
+     */
+    for (size_t h = 16; h <= 18; ++h)
+    {
+        binary_search_tree<size_t> tree;
+
+        /* the ranges [first,last) of keys whose median is inserted next */
+        std::queue<std::pair<size_t, size_t> > ranges;
+        ranges.push({0, size_t(1) << h});
+
+        while (ranges.empty() == false)
+        {
+            const size_t first = ranges.front().first;
+            const size_t last = ranges.front().second;
+            ranges.pop();
+
+            if (last - first > 1)
+            {
+                const size_t middle = first + (last - first) / 2;
+
+                tree.insert(2 * middle);
+                ranges.push({first, middle});
+                ranges.push({middle, last});
+            }
+        }
+
+        const std::vector<size_t> odd_keys = random_vector(size_t(1) << h);
+
+        for (size_t i = 0; i < odd_keys.size() / 4; ++i)
+        {
+            tree.insert(2 * odd_keys[i] + 1);
+        }
+
+        std::vector<std::list<size_t> > lists_bfs = tree.level_node_list_bfs();
+
+        /* p threads are used only if a level has p * 2^14 nodes */
+        const size_t max_threads = size_t(1) << (h - 15);
+
+        assert(lists_bfs[h - 1].size() == (size_t(1) << (h - 1)));
+        assert(check_level_node_list_flat(tree, lists_bfs, 1) == 1);
+        assert(check_level_node_list_flat(tree, lists_bfs, 3) ==
+               std::min<size_t>(3, max_threads));
+        assert(check_level_node_list_flat(tree, lists_bfs, 8) == max_threads);
+
+        std::cout << "passed parallel tests for trees of height " << h + 1
+                  << std::endl;
+    }
+
+    /* sorted keys make binary search trees degenerate, but not B-trees */
+    for (size_t n = 100; n <= 10000; n *= 10)
+    {
+        std::vector<size_t> keys = random_vector(n);
+        std::sort(keys.begin(), keys.end());
+
+        b_tree<size_t, 2> tree_2;
+        b_tree<size_t> tree_16;
+        b_tree<size_t> tree_bulk;
+
+        for (const size_t x : keys)
+        {
+            tree_2.insert(x);
+        }
+        for (auto x = keys.rbegin(); x != keys.rend(); ++x)
+        {
+            tree_16.insert(*x);
+        }
+        tree_bulk.bulk_load(keys.begin(), keys.end());
+
+        check_b_tree(tree_2, keys);
+        check_b_tree(tree_16, keys);
+        check_b_tree(tree_bulk, keys);
+
+        /* bulk loading builds trees of the smallest possible height */
+        size_t capacity = 31;
+        size_t height = 1;
+        while (capacity < n)
+        {
+            capacity = 32 * capacity + 31;
+            ++height;
+        }
+
+        assert(tree_bulk.height() == height);
+
+        std::cout << "passed tests for B-trees built from " << n
+                  << " sorted keys" << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
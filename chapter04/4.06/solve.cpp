@@ -9,6 +9,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /** @brief A node of a binary tree. */
 struct tree_node
 {
@@ -164,6 +168,61 @@ std::vector<tree_node*> random_tree(const size_t n)
     return nodes;
 }
 
+#ifdef BENCHMARK
+
+/* each iteration finds the common ancestors of 64 random pairs of nodes */
+
+template<typename Function>
+void bench_find_common_ancestor(benchmark::state& state,
+                                Function find_common_ancestor)
+{
+    const size_t num_queries = 64;
+
+    std::vector<tree_node*> tree_nodes = random_tree(state.size());
+
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<size_t> node_chooser(0, state.size() - 1);
+
+    std::vector<std::pair<tree_node*, tree_node*>> queries;
+    while (queries.size() < num_queries)
+    {
+        queries.emplace_back(tree_nodes[node_chooser(generator)],
+                             tree_nodes[node_chooser(generator)]);
+    }
+
+    while (state.keep_running())
+    {
+        for (const std::pair<tree_node*, tree_node*>& query : queries)
+        {
+            benchmark::do_not_optimize(
+                find_common_ancestor(query.first, query.second));
+        }
+    }
+
+    state.set_items_processed(num_queries);
+
+    delete tree_nodes.front();
+}
+
+void bench_find_common_ancestor_1(benchmark::state& state)
+{
+    bench_find_common_ancestor(state, find_common_ancestor_1);
+}
+
+void bench_find_common_ancestor_2(benchmark::state& state)
+{
+    bench_find_common_ancestor(state, find_common_ancestor_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 20, 4);
+
+REGISTER_BENCHMARK(bench_find_common_ancestor_1, sizes);
+REGISTER_BENCHMARK(bench_find_common_ancestor_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 50; ++n)
@@ -194,3 +253,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -17,6 +17,11 @@
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Returns the smallest integer which is larger than n but has the same
@@ -225,6 +230,67 @@ uint16_t random_number(uint16_t n)
     return number;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * Each iteration runs a solution on n random 16-bit integers with at least
+ * one bit set and at least one bit unset (so that the answers exist).
+ */
+
+template<typename Function>
+void bench_same_num_bits(benchmark::state& state, Function same_num_bits)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<uint16_t> bit_count(1, 15);
+
+    std::vector<uint16_t> numbers;
+    while (numbers.size() < state.size())
+    {
+        numbers.push_back(random_number(bit_count(generator)));
+    }
+
+    while (state.keep_running())
+    {
+        for (const uint16_t number : numbers)
+        {
+            benchmark::do_not_optimize(same_num_bits(number));
+        }
+    }
+
+    state.set_items_processed(numbers.size());
+}
+
+void bench_smallest_larger_int_same_num_bits_1(benchmark::state& state)
+{
+    bench_same_num_bits(state, smallest_larger_int_same_num_bits_1);
+}
+
+void bench_smallest_larger_int_same_num_bits_2(benchmark::state& state)
+{
+    bench_same_num_bits(state, smallest_larger_int_same_num_bits_2);
+}
+
+void bench_largest_smaller_int_same_num_bits_1(benchmark::state& state)
+{
+    bench_same_num_bits(state, largest_smaller_int_same_num_bits_1);
+}
+
+void bench_largest_smaller_int_same_num_bits_2(benchmark::state& state)
+{
+    bench_same_num_bits(state, largest_smaller_int_same_num_bits_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 16, 16);
+
+REGISTER_BENCHMARK(bench_smallest_larger_int_same_num_bits_1, sizes);
+REGISTER_BENCHMARK(bench_smallest_larger_int_same_num_bits_2, sizes);
+REGISTER_BENCHMARK(bench_largest_smaller_int_same_num_bits_1, sizes);
+REGISTER_BENCHMARK(bench_largest_smaller_int_same_num_bits_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (uint16_t n = 0; n <= 16; ++n)
@@ -256,3 +322,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
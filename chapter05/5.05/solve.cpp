@@ -10,6 +10,11 @@
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Returns the number of bits in x which differ from y.
@@ -46,6 +51,54 @@ size_t num_different_bits_2(const uint32_t x, const uint32_t y)
     return std::bitset<32>(x ^ y).count();
 }
 
+#ifdef BENCHMARK
+
+/* each iteration runs a solution on n pairs of random 32-bit integers */
+
+template<typename Function>
+void bench_num_different_bits(benchmark::state& state,
+                              Function num_different_bits)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<uint32_t> distribution;
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    while (pairs.size() < state.size())
+    {
+        pairs.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    while (state.keep_running())
+    {
+        for (const std::pair<uint32_t, uint32_t>& pair : pairs)
+        {
+            benchmark::do_not_optimize(
+                num_different_bits(pair.first, pair.second));
+        }
+    }
+
+    state.set_items_processed(pairs.size());
+}
+
+void bench_num_different_bits_1(benchmark::state& state)
+{
+    bench_num_different_bits(state, num_different_bits_1);
+}
+
+void bench_num_different_bits_2(benchmark::state& state)
+{
+    bench_num_different_bits(state, num_different_bits_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 20, 16);
+
+REGISTER_BENCHMARK(bench_num_different_bits_1, sizes);
+REGISTER_BENCHMARK(bench_num_different_bits_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -65,3 +118,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -13,6 +13,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief A representation of an array of 32-bit integers such that we can only
  *        access a single bit of a given integer at a time, i.e., the j-th bit
@@ -153,6 +157,41 @@ binary_array random_vector(const uint32_t n)
     return v;
 }
 
+#ifdef BENCHMARK
+
+template<typename Function>
+void bench_find_missing_integer(benchmark::state& state,
+                                Function find_missing_integer)
+{
+    binary_array v = random_vector(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(find_missing_integer(v));
+    }
+
+    state.set_items_processed(v.size());
+}
+
+void bench_find_missing_integer_1(benchmark::state& state)
+{
+    bench_find_missing_integer(state, find_missing_integer_1);
+}
+
+void bench_find_missing_integer_2(benchmark::state& state)
+{
+    bench_find_missing_integer(state, find_missing_integer_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 22, 4);
+
+REGISTER_BENCHMARK(bench_find_missing_integer_1, sizes);
+REGISTER_BENCHMARK(bench_find_missing_integer_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (uint32_t n = 1; n <= 100; ++n)
@@ -170,3 +209,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -8,6 +8,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 using subsets = std::vector<std::vector<size_t> >;
 
 /**
@@ -105,6 +109,49 @@ bool sets_are_equal(subsets U, subsets V)
     return U == V;
 }
 
+#ifdef BENCHMARK
+
+/* the input sizes are the numbers of elements in the set */
+
+template<typename Function>
+void bench_all_subsets(benchmark::state& state, Function all_subsets)
+{
+    std::vector<size_t> values;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        values.push_back(i);
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(all_subsets(values));
+    }
+
+    state.set_items_processed(std::pow(2, state.size()));
+}
+
+void bench_all_subsets_1(benchmark::state& state)
+{
+    bench_all_subsets(state, [](const std::vector<size_t>& values) {
+        return all_subsets_1(values);
+    });
+}
+
+void bench_all_subsets_2(benchmark::state& state)
+{
+    bench_all_subsets(state, all_subsets_2);
+}
+
+const std::vector<size_t> sizes = {4, 8, 12, 16, 20};
+
+REGISTER_BENCHMARK(bench_all_subsets_1, sizes);
+REGISTER_BENCHMARK(bench_all_subsets_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 15; ++n)
@@ -129,3 +176,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
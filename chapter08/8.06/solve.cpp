@@ -13,6 +13,16 @@
 #include <queue>
 #include <random>
 
+#ifdef PERF_COUNTERS
+#include "perf_counters.hpp"
+#else
+#define PERF_REGION(name) static_cast<void>(0)
+#endif
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 enum color
 {
     RED = 0,
@@ -117,6 +127,8 @@ void paint_fill_1(image& I,
                   const size_t j,
                   const color new_color)
 {
+    PERF_REGION("paint_fill_1");
+
     /* if the image has zero area, do nothing */
     if (I.width() == 0 || I.height() == 0)
     {
@@ -208,6 +220,8 @@ void paint_fill_2(image& I,
                   const size_t j,
                   const color new_color)
 {
+    PERF_REGION("paint_fill_2");
+
     /* if the image has zero area, do nothing */
     if (I.width() == 0 || I.height() == 0)
     {
@@ -250,6 +264,52 @@ image random_image(const size_t m, const size_t n)
     return I;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The images are n×n and have a single color, so every fill paints all of
+ * their pixels; the fill color alternates between iterations so that no
+ * image has to be restored. The recursion depth of paint_fill_1 can reach
+ * n², so the images are kept small enough for the default stack.
+ */
+
+template<typename Function>
+void bench_paint_fill(benchmark::state& state, Function paint_fill)
+{
+    const size_t n = state.size();
+
+    image I(n, n);
+
+    color new_color = GREEN;
+
+    while (state.keep_running())
+    {
+        paint_fill(I, n / 2, n / 2, new_color);
+        new_color = (new_color == GREEN) ? RED : GREEN;
+    }
+
+    state.set_items_processed(n * n);
+}
+
+void bench_paint_fill_1(benchmark::state& state)
+{
+    bench_paint_fill(state, paint_fill_1);
+}
+
+void bench_paint_fill_2(benchmark::state& state)
+{
+    bench_paint_fill(state, paint_fill_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(8, 128);
+
+REGISTER_BENCHMARK(bench_paint_fill_1, sizes);
+REGISTER_BENCHMARK(bench_paint_fill_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -301,3 +361,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
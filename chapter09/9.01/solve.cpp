@@ -11,6 +11,12 @@
 #include <random>
 #include <vector>
 
+#ifdef PERF_COUNTERS
+#include "perf_counters.hpp"
+#else
+#define PERF_REGION(name) static_cast<void>(0)
+#endif
+
 /**
  * @brief Merges the values of two sorted arrays v1 and v2 on top of v1.
  * @note Complexity: O(n) in time, O(1) in space, where n = n1 + n2 is the sum
@@ -22,6 +28,8 @@
  */
 void merge(std::vector<int>& v1, const std::vector<int>& v2)
 {
+    PERF_REGION("merge");
+
     /* one past the rightmost unmerged element of v1 */
     size_t i1 = v1.size() - v2.size();
 
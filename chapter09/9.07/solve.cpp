@@ -15,6 +15,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 struct person
 {
     int height;
@@ -226,6 +230,44 @@ group random_group(const size_t n)
     return people;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The groups have n people with random heights and weights; highest_tower_1
+ * takes exponential time, so it is only run on small groups.
+ */
+
+template<typename Function>
+void bench_highest_tower(benchmark::state& state, Function highest_tower)
+{
+    group people = random_group(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(highest_tower(people));
+    }
+
+    state.set_items_processed(people.size());
+}
+
+void bench_highest_tower_1(benchmark::state& state)
+{
+    bench_highest_tower(
+        state, [](const group& people) { return highest_tower_1(people); });
+}
+
+void bench_highest_tower_2(benchmark::state& state)
+{
+    bench_highest_tower(state, highest_tower_2);
+}
+
+REGISTER_BENCHMARK(bench_highest_tower_1, benchmark::range(4, 64));
+REGISTER_BENCHMARK(bench_highest_tower_2, benchmark::range(4, 4096, 4));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 20; ++n)
@@ -247,3 +289,5 @@ int main()
                   << std::endl;
     }
 }
+
+#endif /* BENCHMARK */
@@ -11,6 +11,10 @@
 #include <vector>
 #include "line.h"
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Returns a vector with all lines which connect each pair of points
  *        on an array with n distinct points.
@@ -190,6 +194,46 @@ std::vector<point> random_points(const size_t n)
     return points;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The points are taken from a 10×10 grid (see random_points), so there are
+ * at most 100 of them.
+ */
+
+template<typename Function>
+void bench_line_crosses_most_points(benchmark::state& state,
+                                    Function line_crosses_most_points)
+{
+    std::vector<point> points = random_points(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(line_crosses_most_points(points));
+    }
+
+    state.set_items_processed(points.size());
+}
+
+void bench_line_crosses_most_points_1(benchmark::state& state)
+{
+    bench_line_crosses_most_points(state, line_crosses_most_points_1);
+}
+
+void bench_line_crosses_most_points_2(benchmark::state& state)
+{
+    bench_line_crosses_most_points(state, line_crosses_most_points_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(4, 64);
+
+REGISTER_BENCHMARK(bench_line_crosses_most_points_1, sizes);
+REGISTER_BENCHMARK(bench_line_crosses_most_points_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 2; n <= 20; ++n)
@@ -219,3 +263,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -9,6 +9,10 @@
 #include <limits>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Finds the k-th number of type (3^a)*(5^b)*(7^c) using brute force.
  * @note Complexity: O(k²) in time, O(k) in space.
@@ -142,6 +146,40 @@ bool is_valid(uint64_t n)
     return true;
 }
 
+#ifdef BENCHMARK
+
+/* the input sizes are the indices k of the computed numbers */
+
+template<typename Function>
+void bench_find_number(benchmark::state& state, Function find_number)
+{
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(find_number(state.size()));
+    }
+
+    state.set_items_processed(state.size());
+}
+
+void bench_find_number_1(benchmark::state& state)
+{
+    bench_find_number(state, find_number_1);
+}
+
+void bench_find_number_2(benchmark::state& state)
+{
+    bench_find_number(state, find_number_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1024, 4);
+
+REGISTER_BENCHMARK(bench_find_number_1, sizes);
+REGISTER_BENCHMARK(bench_find_number_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t k = 0; k <= 100; ++k)
@@ -155,3 +193,5 @@ int main()
 
     std::cout << "passed all tests" << std::endl;
 }
+
+#endif /* BENCHMARK */
@@ -8,6 +8,10 @@
 #include <cmath>
 #include <iostream>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Computes n!.
  * @note Complexity: O(n) in time, O(1) in space.
@@ -90,6 +94,41 @@ uint64_t trailing_zeros_2(uint64_t n)
     return count;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The input sizes are the values of n; trailing_zeros_1 computes n!, which
+ * overflows a 64-bit integer for n > 20.
+ */
+
+template<typename Function>
+void bench_trailing_zeros(benchmark::state& state, Function trailing_zeros)
+{
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(trailing_zeros(state.size()));
+    }
+}
+
+void bench_trailing_zeros_1(benchmark::state& state)
+{
+    bench_trailing_zeros(state, trailing_zeros_1);
+}
+
+void bench_trailing_zeros_2(benchmark::state& state)
+{
+    bench_trailing_zeros(state, trailing_zeros_2);
+}
+
+const std::vector<size_t> sizes = {5, 10, 15, 20};
+
+REGISTER_BENCHMARK(bench_trailing_zeros_1, sizes);
+REGISTER_BENCHMARK(bench_trailing_zeros_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (uint64_t n = 0; n <= 20; ++n)
@@ -99,3 +138,5 @@ int main()
         std::cout << "passed test for n = " << n << std::endl;
     }
 }
+
+#endif /* BENCHMARK */
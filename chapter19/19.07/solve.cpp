@@ -9,6 +9,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Computes the largest contiguous-sequence sum using brute force.
  * @note Complexity: O(n²) in time, O(1) in space.
@@ -58,6 +62,49 @@ int sequence_largest_sum_2(const std::vector<int>& values)
     return max_sum;
 }
 
+#ifdef BENCHMARK
+
+template<typename Function>
+void bench_sequence_largest_sum(benchmark::state& state,
+                                Function sequence_largest_sum)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<int> distribution(-100, 100);
+
+    std::vector<int> values;
+    while (values.size() < state.size())
+    {
+        values.push_back(distribution(generator));
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(sequence_largest_sum(values));
+    }
+
+    state.set_items_processed(values.size());
+}
+
+void bench_sequence_largest_sum_1(benchmark::state& state)
+{
+    bench_sequence_largest_sum(state, sequence_largest_sum_1);
+}
+
+void bench_sequence_largest_sum_2(benchmark::state& state)
+{
+    bench_sequence_largest_sum(state, sequence_largest_sum_2);
+}
+
+/* sequence_largest_sum_1 is quadratic, so it is only run on shorter arrays */
+REGISTER_BENCHMARK(bench_sequence_largest_sum_1,
+                   benchmark::range(16, 1 << 16, 4));
+REGISTER_BENCHMARK(bench_sequence_largest_sum_2,
+                   benchmark::range(16, 1 << 24, 4));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -86,3 +133,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -10,6 +10,10 @@
 #include <unordered_set>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 using int_pair = std::pair<int, int>;
 
 /**
@@ -102,6 +106,45 @@ std::vector<int> random_vector(const size_t n)
     return v;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The arrays have n random values in [-100,100] (see random_vector) and the
+ * target sum is zero.
+ */
+
+template<typename Function>
+void bench_two_sum(benchmark::state& state, Function two_sum)
+{
+    std::vector<int> v = random_vector(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(two_sum(v, 0));
+    }
+
+    state.set_items_processed(v.size());
+}
+
+void bench_two_sum_1(benchmark::state& state)
+{
+    bench_two_sum(state, two_sum_1);
+}
+
+void bench_two_sum_2(benchmark::state& state)
+{
+    bench_two_sum(state, two_sum_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 22, 4);
+
+REGISTER_BENCHMARK(bench_two_sum_1, sizes);
+REGISTER_BENCHMARK(bench_two_sum_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -132,3 +175,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
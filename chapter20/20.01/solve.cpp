@@ -6,6 +6,11 @@
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <vector>
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
 
 /**
  * @brief Adds two integers a and b without arithmetic operations.
@@ -67,6 +72,52 @@ uint32_t add_2(const uint32_t a, const uint32_t b)
     return add_2(sum_no_carry, carry_values);
 }
 
+#ifdef BENCHMARK
+
+/* each iteration adds n pairs of random 32-bit integers */
+
+template<typename Function>
+void bench_add(benchmark::state& state, Function add)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<uint32_t> distribution;
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    while (pairs.size() < state.size())
+    {
+        pairs.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    while (state.keep_running())
+    {
+        for (const std::pair<uint32_t, uint32_t>& pair : pairs)
+        {
+            benchmark::do_not_optimize(add(pair.first, pair.second));
+        }
+    }
+
+    state.set_items_processed(pairs.size());
+}
+
+void bench_add_1(benchmark::state& state)
+{
+    bench_add(state, add_1);
+}
+
+void bench_add_2(benchmark::state& state)
+{
+    bench_add(state, add_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 20, 16);
+
+REGISTER_BENCHMARK(bench_add_1, sizes);
+REGISTER_BENCHMARK(bench_add_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -87,3 +138,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
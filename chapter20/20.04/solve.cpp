@@ -7,6 +7,10 @@
 #include <cassert>
 #include <iostream>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Returns the number of '2's in a nonnegative integer n.
  * @note Complexity: O(log10(n)) in time, O(1) in space, since the number of
@@ -76,6 +80,39 @@ int count_twos_in_range_2(const int n)
            (highest_digit == 2) * (remainder + 1);
 }
 
+#ifdef BENCHMARK
+
+/* the input sizes are the upper limits n of the ranges [0,n] */
+
+template<typename Function>
+void bench_count_twos_in_range(benchmark::state& state,
+                               Function count_twos_in_range)
+{
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(count_twos_in_range(state.size()));
+    }
+}
+
+void bench_count_twos_in_range_1(benchmark::state& state)
+{
+    bench_count_twos_in_range(state, count_twos_in_range_1);
+}
+
+void bench_count_twos_in_range_2(benchmark::state& state)
+{
+    bench_count_twos_in_range(state, count_twos_in_range_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(10, 10000000, 10);
+
+REGISTER_BENCHMARK(bench_count_twos_in_range_1, sizes);
+REGISTER_BENCHMARK(bench_count_twos_in_range_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (int n = 0; n < 10000; ++n)
@@ -87,3 +124,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -9,6 +9,10 @@
 #include <string>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 const size_t infinity = std::numeric_limits<size_t>::max();
 
 /**
@@ -125,6 +129,52 @@ std::string random_string()
     return str;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The files have n random words (see random_string) and each iteration
+ * computes the distance between their first and last words.
+ */
+
+template<typename Function>
+void bench_shortest_distance(benchmark::state& state,
+                             Function shortest_distance)
+{
+    std::vector<std::string> words;
+
+    while (words.size() < state.size())
+    {
+        words.push_back(random_string());
+    }
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(
+            shortest_distance(words, words.front(), words.back()));
+    }
+
+    state.set_items_processed(words.size());
+}
+
+void bench_shortest_distance_1(benchmark::state& state)
+{
+    bench_shortest_distance(state, shortest_distance_1);
+}
+
+void bench_shortest_distance_2(benchmark::state& state)
+{
+    bench_shortest_distance(state, shortest_distance_2);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 20, 4);
+
+REGISTER_BENCHMARK(bench_shortest_distance_1, sizes);
+REGISTER_BENCHMARK(bench_shortest_distance_2, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 100; ++n)
@@ -165,3 +215,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
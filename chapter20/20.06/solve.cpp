@@ -10,6 +10,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Returns the m largest elements of an array using quick-select.
  * @note Complexity: O(m) in time (on average), O(n) in space, where n is the
@@ -126,6 +130,57 @@ std::vector<int> get_m_largest_3(std::vector<int> values, const size_t m)
     return {values.end() - m, values.end()};
 }
 
+#ifdef BENCHMARK
+
+/* each iteration gets the n/16 largest of n random values */
+
+template<typename Function>
+void bench_get_m_largest(benchmark::state& state, Function get_m_largest)
+{
+    std::mt19937 generator(state.size());
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+
+    std::vector<int> values;
+    while (values.size() < state.size())
+    {
+        values.push_back(distribution(generator));
+    }
+
+    const size_t m = std::max<size_t>(values.size() / 16, 1);
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(get_m_largest(values, m));
+    }
+
+    state.set_items_processed(values.size());
+}
+
+void bench_get_m_largest_1(benchmark::state& state)
+{
+    bench_get_m_largest(state, get_m_largest_1);
+}
+
+void bench_get_m_largest_2(benchmark::state& state)
+{
+    bench_get_m_largest(state, get_m_largest_2);
+}
+
+void bench_get_m_largest_3(benchmark::state& state)
+{
+    bench_get_m_largest(state, get_m_largest_3);
+}
+
+const std::vector<size_t> sizes = benchmark::range(16, 1 << 22, 4);
+
+REGISTER_BENCHMARK(bench_get_m_largest_1, sizes);
+REGISTER_BENCHMARK(bench_get_m_largest_2, sizes);
+REGISTER_BENCHMARK(bench_get_m_largest_3, sizes);
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     std::random_device device;
@@ -164,3 +219,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
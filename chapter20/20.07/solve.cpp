@@ -12,6 +12,10 @@
 #include <string>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /**
  * @brief Determines the longest string in an array of strings v which is the
  *        concatenation of some pair of strings in v using brute force; if no
@@ -125,6 +129,42 @@ std::vector<std::string> random_strings(const size_t n)
     return v;
 }
 
+#ifdef BENCHMARK
+
+template<typename Function>
+void bench_longest_concatenated_string(benchmark::state& state,
+                                       Function longest_concatenated_string)
+{
+    std::vector<std::string> v = random_strings(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(longest_concatenated_string(v));
+    }
+
+    state.set_items_processed(v.size());
+}
+
+void bench_longest_concatenated_string_1(benchmark::state& state)
+{
+    bench_longest_concatenated_string(state, longest_concatenated_string_1);
+}
+
+void bench_longest_concatenated_string_2(benchmark::state& state)
+{
+    bench_longest_concatenated_string(state, longest_concatenated_string_2);
+}
+
+/* longest_concatenated_string_1 is cubic, so it is only run on fewer strings */
+REGISTER_BENCHMARK(bench_longest_concatenated_string_1,
+                   benchmark::range(4, 256));
+REGISTER_BENCHMARK(bench_longest_concatenated_string_2,
+                   benchmark::range(4, 1 << 16, 4));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 50; ++n)
@@ -155,3 +195,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
@@ -9,6 +9,10 @@
 #include <random>
 #include <vector>
 
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 /** @brief A matrix-like class for representing a board. */
 template<typename T>
 class board
@@ -233,6 +237,41 @@ board<color> random_board(const size_t n)
     return B;
 }
 
+#ifdef BENCHMARK
+
+/* the input sizes are the board sizes n (the boards are n×n) */
+
+template<typename Function>
+void bench_maximum_subsquare(benchmark::state& state,
+                             Function maximum_subsquare)
+{
+    board<color> B = random_board(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(maximum_subsquare(B));
+    }
+
+    state.set_items_processed(state.size() * state.size());
+}
+
+void bench_maximum_subsquare_1(benchmark::state& state)
+{
+    bench_maximum_subsquare(state, maximum_subsquare_1);
+}
+
+void bench_maximum_subsquare_2(benchmark::state& state)
+{
+    bench_maximum_subsquare(state, maximum_subsquare_2);
+}
+
+REGISTER_BENCHMARK(bench_maximum_subsquare_1, benchmark::range(4, 512));
+REGISTER_BENCHMARK(bench_maximum_subsquare_2, benchmark::range(4, 128));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 20; ++n)
@@ -256,3 +295,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
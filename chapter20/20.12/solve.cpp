@@ -9,6 +9,16 @@
 #include <random>
 #include <vector>
 
+#ifdef PERF_COUNTERS
+#include "perf_counters.hpp"
+#else
+#define PERF_REGION(name) static_cast<void>(0)
+#endif
+
+#ifdef BENCHMARK
+#include "benchmark.hpp"
+#endif
+
 class matrix
 {
 public:
@@ -91,6 +101,8 @@ int matrix_sum(const matrix& M)
  */
 matrix largest_sum_submatrix_1(const matrix& M)
 {
+    PERF_REGION("largest_sum_submatrix_1");
+
     size_t n = M.num_rows();
 
     if (n == 0)
@@ -159,6 +171,8 @@ matrix largest_sum_submatrix_1(const matrix& M)
  */
 matrix largest_sum_submatrix_2(const matrix& M)
 {
+    PERF_REGION("largest_sum_submatrix_2");
+
     size_t n = M.num_rows();
 
     if (n == 0)
@@ -267,6 +281,45 @@ matrix random_matrix(const size_t n)
     return M;
 }
 
+#ifdef BENCHMARK
+
+/*
+ * The input sizes are the matrix sizes n (the matrices are n×n);
+ * largest_sum_submatrix_1 takes O(n^6) time, so it is only run on small
+ * matrices.
+ */
+
+template<typename Function>
+void bench_largest_sum_submatrix(benchmark::state& state,
+                                 Function largest_sum_submatrix)
+{
+    matrix M = random_matrix(state.size());
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(largest_sum_submatrix(M));
+    }
+
+    state.set_items_processed(state.size() * state.size());
+}
+
+void bench_largest_sum_submatrix_1(benchmark::state& state)
+{
+    bench_largest_sum_submatrix(state, largest_sum_submatrix_1);
+}
+
+void bench_largest_sum_submatrix_2(benchmark::state& state)
+{
+    bench_largest_sum_submatrix(state, largest_sum_submatrix_2);
+}
+
+REGISTER_BENCHMARK(bench_largest_sum_submatrix_1, benchmark::range(4, 32));
+REGISTER_BENCHMARK(bench_largest_sum_submatrix_2, benchmark::range(4, 128));
+
+BENCHMARK_MAIN()
+
+#else
+
 int main()
 {
     for (size_t n = 0; n <= 20; ++n)
@@ -287,3 +340,5 @@ int main()
 
     return EXIT_SUCCESS;
 }
+
+#endif /* BENCHMARK */
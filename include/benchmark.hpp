@@ -0,0 +1,521 @@
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+/*
+ * A minimal header-only benchmark harness shared by the solutions.
+ *
+ * A benchmark is a function which takes a benchmark::state, prepares an input
+ * of size state.size() and runs the code to measure while keep_running()
+ * returns true:
+ *
+ *     void bench_solve_1(benchmark::state& state)
+ *     {
+ *         std::string str = random_string(state.size());
+ *
+ *         while (state.keep_running())
+ *         {
+ *             benchmark::do_not_optimize(solve_1(str));
+ *         }
+ *
+ *         state.set_bytes_processed(str.size());
+ *     }
+ *     REGISTER_BENCHMARK(bench_solve_1, benchmark::range(16, 1 << 20, 4));
+ *
+ *     BENCHMARK_MAIN()
+ *
+ * Each benchmark is run once for every input size in its sweep: it is first
+ * warmed up, then timed in a number of samples (each sample times a batch of
+ * iterations long enough for the clock resolution not to matter). Besides
+ * timings and throughputs, a benchmark can report its own measurements (e.g.
+ * memory usage) with set_counter(). The results are written to the standard
+ * output as CSV (default) or JSON:
+ *
+ *     ./solve-bench [--format=csv|json] [--filter=<substring>]
+ *                   [--min-size=<n>] [--max-size=<n>] [--samples=<n>]
+ *                   [--max-time=<seconds>]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace benchmark
+{
+/** @brief Settings shared by all benchmarks of a run. */
+struct options
+{
+    /* time spent running a benchmark before it is measured */
+    double warmup_time = 0.05;
+
+    /* number of timed samples per benchmark and input size */
+    size_t samples = 20;
+
+    /* measured time after which a benchmark stops taking samples */
+    double max_time = 2.0;
+
+    /* target duration of each sample */
+    double sample_time = 0.01;
+
+    size_t min_size = 0;
+    size_t max_size = static_cast<size_t>(-1);
+
+    bool json = false;
+    std::string filter;
+};
+
+/** @brief Prevents the compiler from optimizing away a computed value. */
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "m"(value) : "memory");
+}
+
+/** @brief Prevents the compiler from caching memory contents in registers. */
+inline void clobber_memory()
+{
+    asm volatile("" : : : "memory");
+}
+
+/** @brief The state of a benchmark while it is being run for an input size. */
+class state
+{
+    using clock = std::chrono::steady_clock;
+
+public:
+    state(const size_t size, const options& settings)
+        : size_(size), settings_(settings)
+    {
+        /* nothing needs to be done here */
+    }
+
+    /** @brief Returns the input size the benchmark must use. */
+    size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns true while the benchmarked code must be run again.
+     * @note The clock is only read at the end of each batch of iterations.
+     */
+    bool keep_running()
+    {
+        if (remaining_ > 0)
+        {
+            --remaining_;
+            return true;
+        }
+
+        clock::time_point now = clock::now();
+
+        if (started_ == false)
+        {
+            started_ = true;
+            start_batch(now, 1);
+            return keep_running();
+        }
+
+        double elapsed =
+            std::chrono::duration<double>(now - batch_start_).count() -
+            paused_;
+
+        if (warming_up_)
+        {
+            warmup_elapsed_ += elapsed;
+            warmup_iterations_ += batch_;
+
+            if (warmup_elapsed_ < settings_.warmup_time)
+            {
+                /* double the batch size until the warm-up time is reached */
+                start_batch(clock::now(), 2 * batch_);
+                return keep_running();
+            }
+
+            warming_up_ = false;
+
+            double per_iteration = warmup_elapsed_ / warmup_iterations_;
+            size_t batch =
+                static_cast<size_t>(settings_.sample_time / per_iteration);
+
+            start_batch(clock::now(), std::max<size_t>(batch, 1));
+            return keep_running();
+        }
+
+        samples_.push_back(elapsed / batch_);
+        iterations_ += batch_;
+        measured_ += elapsed;
+
+        if (samples_.size() >= settings_.samples ||
+            measured_ >= settings_.max_time)
+        {
+            return false;
+        }
+
+        start_batch(clock::now(), batch_);
+        return keep_running();
+    }
+
+    /** @brief Stops the clock (e.g. to restore a modified input). */
+    void pause_timing()
+    {
+        pause_start_ = clock::now();
+    }
+
+    /** @brief Restarts the clock after a call to pause_timing(). */
+    void resume_timing()
+    {
+        paused_ +=
+            std::chrono::duration<double>(clock::now() - pause_start_).count();
+    }
+
+    /** @brief Sets the number of items processed by each iteration. */
+    void set_items_processed(const double items)
+    {
+        items_ = items;
+    }
+
+    /** @brief Sets the number of bytes processed by each iteration. */
+    void set_bytes_processed(const double bytes)
+    {
+        bytes_ = bytes;
+    }
+
+    /** @brief Returns the time per iteration of each sample (in seconds). */
+    const std::vector<double>& samples() const
+    {
+        return samples_;
+    }
+
+    /** @brief Returns the number of measured iterations. */
+    size_t iterations() const
+    {
+        return iterations_;
+    }
+
+    /**
+     * @brief Sets a named value measured by the benchmark (reported as is,
+     *        e.g. a memory utilization ratio).
+     */
+    void set_counter(const std::string& name, const double value)
+    {
+        for (std::pair<std::string, double>& counter : counters_)
+        {
+            if (counter.first == name)
+            {
+                counter.second = value;
+                return;
+            }
+        }
+
+        counters_.emplace_back(name, value);
+    }
+
+    double items_processed() const
+    {
+        return items_;
+    }
+
+    double bytes_processed() const
+    {
+        return bytes_;
+    }
+
+    const std::vector<std::pair<std::string, double>>& counters() const
+    {
+        return counters_;
+    }
+
+private:
+    void start_batch(const clock::time_point now, const size_t batch)
+    {
+        batch_ = batch;
+        remaining_ = batch;
+        paused_ = 0;
+        batch_start_ = now;
+    }
+
+    size_t size_;
+    const options& settings_;
+
+    bool started_ = false;
+    bool warming_up_ = true;
+
+    size_t batch_ = 0;
+    size_t remaining_ = 0;
+    clock::time_point batch_start_;
+    clock::time_point pause_start_;
+    double paused_ = 0;
+
+    double warmup_elapsed_ = 0;
+    size_t warmup_iterations_ = 0;
+
+    std::vector<double> samples_;
+    size_t iterations_ = 0;
+    double measured_ = 0;
+
+    double items_ = 0;
+    double bytes_ = 0;
+
+    std::vector<std::pair<std::string, double>> counters_;
+};
+
+/** @brief A benchmark and the input sizes it is run for. */
+struct entry
+{
+    std::string name;
+    void (*function)(state&);
+    std::vector<size_t> sizes;
+};
+
+/** @brief Returns the list of registered benchmarks. */
+inline std::vector<entry>& registry()
+{
+    static std::vector<entry> entries;
+    return entries;
+}
+
+/** @brief Registers a benchmark when constructed (see REGISTER_BENCHMARK). */
+struct registration
+{
+    registration(const char* name,
+                 void (*function)(state&),
+                 const std::vector<size_t>& sizes)
+    {
+        registry().push_back(entry{name, function, sizes});
+    }
+};
+
+/**
+ * @brief Returns the sizes first, first*factor, first*factor², ... up to
+ *        (and including) last.
+ */
+inline std::vector<size_t> range(const size_t first,
+                                 const size_t last,
+                                 const size_t factor = 2)
+{
+    std::vector<size_t> sizes;
+
+    for (size_t size = first; size <= last; size *= factor)
+    {
+        sizes.push_back(size);
+
+        if (size == 0 || size > last / factor)
+        {
+            break;
+        }
+    }
+
+    return sizes;
+}
+
+/**
+ * @brief Returns the p-th percentile (0 <= p <= 1) of a sorted sequence
+ *        (using the nearest-rank method).
+ */
+inline double percentile(const std::vector<double>& sorted, const double p)
+{
+    size_t rank = static_cast<size_t>(p * sorted.size() + 0.5);
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+/** @brief Writes the results of a benchmark run for an input size. */
+inline void report(std::ostream& out,
+                   const std::string& name,
+                   const state& result,
+                   const bool json,
+                   const bool first)
+{
+    std::vector<double> sorted = result.samples();
+    std::sort(sorted.begin(), sorted.end());
+
+    double mean = 0;
+    for (double sample : sorted)
+    {
+        mean += sample / sorted.size();
+    }
+
+    /* times are reported in nanoseconds, throughputs per second */
+    const char* fields[] = {"mean_ns",
+                            "min_ns",
+                            "p50_ns",
+                            "p90_ns",
+                            "p99_ns",
+                            "max_ns",
+                            "items_per_second",
+                            "bytes_per_second"};
+    double p50 = percentile(sorted, 0.5);
+    double values[] = {1e9 * mean,
+                       1e9 * sorted.front(),
+                       1e9 * p50,
+                       1e9 * percentile(sorted, 0.9),
+                       1e9 * percentile(sorted, 0.99),
+                       1e9 * sorted.back(),
+                       result.items_processed() / p50,
+                       result.bytes_processed() / p50};
+
+    out << std::setprecision(6);
+
+    if (json)
+    {
+        out << (first ? "[\n" : ",\n") << "  {\"name\": \"" << name
+            << "\", \"size\": " << result.size()
+            << ", \"samples\": " << sorted.size()
+            << ", \"iterations\": " << result.iterations();
+        for (size_t i = 0; i < 8; ++i)
+        {
+            out << ", \"" << fields[i] << "\": " << values[i];
+        }
+        out << ", \"counters\": {";
+        for (size_t i = 0; i < result.counters().size(); ++i)
+        {
+            out << (i > 0 ? ", \"" : "\"") << result.counters()[i].first
+                << "\": " << result.counters()[i].second;
+        }
+        out << "}}";
+        return;
+    }
+
+    if (first)
+    {
+        out << "name,size,samples,iterations";
+        for (const char* field : fields)
+        {
+            out << "," << field;
+        }
+        out << ",counters\n";
+    }
+
+    out << name << "," << result.size() << "," << sorted.size() << ","
+        << result.iterations();
+    for (double value : values)
+    {
+        out << "," << value;
+    }
+
+    /* the counters are written as "name=value" pairs separated by ';' */
+    out << ",";
+    for (size_t i = 0; i < result.counters().size(); ++i)
+    {
+        out << (i > 0 ? ";" : "") << result.counters()[i].first << "="
+            << result.counters()[i].second;
+    }
+    out << std::endl;
+}
+
+/** @brief Parses the command-line arguments into a set of options. */
+inline options parse_options(const int argc, char** argv)
+{
+    options settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+
+        if (arg == "--format=json")
+        {
+            settings.json = true;
+        }
+        else if (arg == "--format=csv")
+        {
+            settings.json = false;
+        }
+        else if (arg.compare(0, 9, "--filter=") == 0)
+        {
+            settings.filter = value;
+        }
+        else if (arg.compare(0, 11, "--min-size=") == 0)
+        {
+            settings.min_size = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (arg.compare(0, 11, "--max-size=") == 0)
+        {
+            settings.max_size = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (arg.compare(0, 10, "--samples=") == 0)
+        {
+            settings.samples = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (arg.compare(0, 11, "--max-time=") == 0)
+        {
+            settings.max_time = std::strtod(value.c_str(), nullptr);
+        }
+        else
+        {
+            std::cerr << "unknown argument: " << arg << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    settings.samples = std::max<size_t>(settings.samples, 1);
+
+    return settings;
+}
+
+/** @brief Runs all registered benchmarks and reports their results. */
+inline int run(const int argc, char** argv)
+{
+    options settings = parse_options(argc, argv);
+
+    bool first = true;
+
+    for (const entry& benchmark : registry())
+    {
+        if (benchmark.name.find(settings.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for (size_t size : benchmark.sizes)
+        {
+            if (size < settings.min_size || size > settings.max_size)
+            {
+                continue;
+            }
+
+            state result(size, settings);
+            benchmark.function(result);
+
+            /* the benchmark did not call keep_running() until the end */
+            if (result.samples().empty())
+            {
+                std::cerr << benchmark.name << ": no samples" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            report(std::cout, benchmark.name, result, settings.json, first);
+            first = false;
+        }
+    }
+
+    if (settings.json)
+    {
+        std::cout << (first ? "[]" : "\n]") << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+} /* namespace benchmark */
+
+/**
+ * @brief Registers a benchmark function, which is run for each input size in
+ *        the given sweep (a std::vector<size_t>, e.g. benchmark::range(...)).
+ */
+#define REGISTER_BENCHMARK(function, sizes)                      \
+    static const ::benchmark::registration registration_##function( \
+        #function, function, sizes)
+
+/** @brief Defines a main() function which runs all registered benchmarks. */
+#define BENCHMARK_MAIN()                     \
+    int main(int argc, char** argv)          \
+    {                                        \
+        return ::benchmark::run(argc, argv); \
+    }
+
+#endif /* __BENCHMARK_HPP__ */
@@ -0,0 +1,362 @@
+#ifndef __PERF_COUNTERS_HPP__
+#define __PERF_COUNTERS_HPP__
+
+/*
+ * An optional instrumentation layer which measures named regions of code with
+ * hardware performance counters (cycles, instructions, cache misses and branch
+ * misses) through the Linux perf_event_open interface:
+ *
+ *     void solve(...)
+ *     {
+ *         PERF_REGION("solve");
+ *         ...
+ *     }
+ *
+ * Each region accumulates the counter deltas between the PERF_REGION statement
+ * and the end of the enclosing scope (regions may be nested). A report with
+ * the totals of every region is written when the program exits, either to the
+ * file named by the PERF_REPORT environment variable or to the standard error.
+ *
+ * The layer is compiled out (PERF_REGION expands to nothing) unless the code
+ * is compiled with -DPERF_COUNTERS, which the Makefiles do when invoked as
+ * "make PERF=1". Solutions only include this header in that case (defining
+ * PERF_REGION as a no-op themselves otherwise), so their tests still build
+ * without it. If the counters cannot be opened (e.g. not running on Linux,
+ * or perf_event_paranoid forbids it), regions are only timed, using the time
+ * stamp counter on x86 and std::chrono::steady_clock elsewhere.
+ *
+ * NOTE: The counters only count events in the thread which opens them (the
+ *       first one to enter a region), so regions must not be entered by other
+ *       threads.
+ */
+
+#ifdef PERF_COUNTERS
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace perf
+{
+/** @brief The hardware events measured by each region. */
+enum event
+{
+    CYCLES = 0,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    NUM_EVENTS
+};
+
+/** @brief Returns a timestamp (in the units given by clock_name()). */
+inline uint64_t timestamp()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/** @brief Returns the name of the clock used by timestamp(). */
+inline const char* clock_name()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return "tsc_ticks";
+#else
+    return "steady_clock_ns";
+#endif
+}
+
+/** @brief A group of hardware counters which are read together. */
+class counter_group
+{
+public:
+    counter_group()
+    {
+#ifdef __linux__
+        const uint64_t configs[NUM_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES,
+                                              PERF_COUNT_HW_INSTRUCTIONS,
+                                              PERF_COUNT_HW_CACHE_MISSES,
+                                              PERF_COUNT_HW_BRANCH_MISSES};
+
+        for (int i = 0; i < NUM_EVENTS; ++i)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.disabled = (i == 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            /* the first counter is the group leader */
+            fds_[i] = syscall(
+                __NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds_[0], 0);
+
+            if (fds_[i] < 0)
+            {
+                close_all();
+                return;
+            }
+        }
+
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~counter_group()
+    {
+        close_all();
+    }
+
+    counter_group(const counter_group&) = delete;
+    counter_group& operator=(const counter_group&) = delete;
+
+    /** @brief Returns true if the hardware counters could be opened. */
+    bool available() const
+    {
+        return fds_[0] >= 0;
+    }
+
+    /**
+     * @brief Reads the current counter values into values.
+     * @return true if the counters were read, false otherwise.
+     */
+    bool read(uint64_t (&values)[NUM_EVENTS]) const
+    {
+#ifdef __linux__
+        if (available() == false)
+        {
+            return false;
+        }
+
+        /* with PERF_FORMAT_GROUP: the number of counters, then their values */
+        uint64_t buffer[1 + NUM_EVENTS];
+
+        if (::read(fds_[0], buffer, sizeof(buffer)) != sizeof(buffer))
+        {
+            return false;
+        }
+
+        for (int i = 0; i < NUM_EVENTS; ++i)
+        {
+            values[i] = buffer[1 + i];
+        }
+
+        return true;
+#else
+        (void)values;
+        return false;
+#endif
+    }
+
+private:
+    void close_all()
+    {
+#ifdef __linux__
+        for (int& fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+#endif
+    }
+
+    int fds_[NUM_EVENTS] = {-1, -1, -1, -1};
+};
+
+/** @brief Returns the counter group shared by all regions. */
+inline const counter_group& counters()
+{
+    static counter_group group;
+    return group;
+}
+
+/** @brief The accumulated measurements of a named region. */
+struct region
+{
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t ticks = 0;
+    uint64_t totals[NUM_EVENTS] = {};
+};
+
+/** @brief Writes the measurements of a set of regions as CSV. */
+inline void write_report(std::FILE* out,
+                         const std::vector<std::unique_ptr<region>>& regions)
+{
+    const bool hardware = counters().available();
+
+    std::fprintf(out,
+                 "# counters: %s\n",
+                 hardware ? "perf_event_open" : "unavailable (timing only)");
+    std::fprintf(out,
+                 "region,calls,%s,cycles,instructions,ipc,cache_misses,"
+                 "branch_misses\n",
+                 clock_name());
+
+    for (const std::unique_ptr<region>& r : regions)
+    {
+        std::fprintf(out,
+                     "%s,%llu,%llu",
+                     r->name.c_str(),
+                     static_cast<unsigned long long>(r->calls),
+                     static_cast<unsigned long long>(r->ticks));
+
+        if (hardware == false)
+        {
+            std::fprintf(out, ",,,,,\n");
+            continue;
+        }
+
+        const uint64_t cycles = r->totals[CYCLES];
+        const uint64_t instructions = r->totals[INSTRUCTIONS];
+
+        std::fprintf(out,
+                     ",%llu,%llu,%.3f,%llu,%llu\n",
+                     static_cast<unsigned long long>(cycles),
+                     static_cast<unsigned long long>(instructions),
+                     cycles > 0 ? static_cast<double>(instructions) / cycles
+                                : 0.0,
+                     static_cast<unsigned long long>(r->totals[CACHE_MISSES]),
+                     static_cast<unsigned long long>(r->totals[BRANCH_MISSES]));
+    }
+}
+
+/** @brief The set of all regions, which is reported when the program exits. */
+class registry
+{
+public:
+    ~registry()
+    {
+        const char* path = std::getenv("PERF_REPORT");
+
+        std::FILE* out = path ? std::fopen(path, "w") : stderr;
+
+        if (out == nullptr)
+        {
+            std::perror(path);
+            return;
+        }
+
+        write_report(out, regions_);
+
+        if (out != stderr)
+        {
+            std::fclose(out);
+        }
+    }
+
+    /** @brief Returns the region with a given name (creating it if needed). */
+    region& get(const char* name)
+    {
+        for (const std::unique_ptr<region>& r : regions_)
+        {
+            if (r->name == name)
+            {
+                return *r;
+            }
+        }
+
+        regions_.emplace_back(new region);
+        regions_.back()->name = name;
+
+        return *regions_.back();
+    }
+
+private:
+    std::vector<std::unique_ptr<region>> regions_;
+};
+
+/** @brief Returns the region with a given name (reported at exit). */
+inline region& get_region(const char* name)
+{
+    /* make sure the counters outlive the registry, which reads them */
+    counters();
+
+    static registry regions;
+    return regions.get(name);
+}
+
+/** @brief Measures a region from its construction until its destruction. */
+class scoped_region
+{
+public:
+    explicit scoped_region(region& r) : region_(r)
+    {
+        hardware_ = counters().read(start_);
+        ticks_ = timestamp();
+    }
+
+    ~scoped_region()
+    {
+        const uint64_t ticks = timestamp();
+
+        uint64_t end[NUM_EVENTS];
+
+        if (hardware_ && counters().read(end))
+        {
+            for (int i = 0; i < NUM_EVENTS; ++i)
+            {
+                region_.totals[i] += end[i] - start_[i];
+            }
+        }
+
+        region_.ticks += ticks - ticks_;
+        ++region_.calls;
+    }
+
+    scoped_region(const scoped_region&) = delete;
+    scoped_region& operator=(const scoped_region&) = delete;
+
+private:
+    region& region_;
+    bool hardware_;
+    uint64_t ticks_;
+    uint64_t start_[NUM_EVENTS];
+};
+} /* namespace perf */
+
+#define PERF_CONCATENATE_(a, b) a##b
+#define PERF_CONCATENATE(a, b) PERF_CONCATENATE_(a, b)
+
+/**
+ * @brief Measures the code from this statement until the end of the enclosing
+ *        scope as the region with the given name.
+ */
+#define PERF_REGION(name)                                             \
+    static ::perf::region& PERF_CONCATENATE(perf_region_, __LINE__) = \
+        ::perf::get_region(name);                                     \
+    ::perf::scoped_region PERF_CONCATENATE(perf_scope_, __LINE__)(    \
+        PERF_CONCATENATE(perf_region_, __LINE__))
+
+#else
+
+#define PERF_REGION(name) static_cast<void>(0)
+
+#endif /* PERF_COUNTERS */
+
+#endif /* __PERF_COUNTERS_HPP__ */